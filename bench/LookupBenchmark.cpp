@@ -0,0 +1,90 @@
+// Compares file lookups through an archive's lookup index against the binary search over its table of contents, with full and compact tables of contents.
+// Usage: HakoLookupBenchmark [file count] [lookup count]
+#include <Hako/Hako.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    double TimeLookups(char const* a_ArchivePath, std::vector<hako::ResourcePathHash> const& a_Lookups)
+    {
+        hako::Archive archive(a_ArchivePath, nullptr, hako::Platform::Windows, hako::FileOpenMode::Read);
+
+        size_t totalSize = 0;
+        auto const start = std::chrono::steady_clock::now();
+        for (hako::ResourcePathHash const& hash : a_Lookups)
+        {
+            totalSize += archive.GetFileSize(hash);
+        }
+        auto const end = std::chrono::steady_clock::now();
+
+        // Use the result so the lookups can't be optimized away
+        if (totalSize == 0)
+        {
+            printf("No files were found\n");
+        }
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / a_Lookups.size();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t const fileCount = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100000;
+    size_t const lookupCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 10000000;
+
+    std::filesystem::path const workingDirectory = std::filesystem::temp_directory_path() / "HakoLookupBenchmark";
+    std::filesystem::remove_all(workingDirectory);
+    hako::SetIntermediateDirectory((workingDirectory / "Intermediate").string().c_str());
+
+    std::vector<hako::ResourcePathHash> hashes;
+    hashes.reserve(fileCount);
+    std::vector<char> const data(16, 'x');
+    for (size_t i = 0; i < fileCount; ++i)
+    {
+        std::string const path = "Assets/File" + std::to_string(i) + ".bin";
+        hako::ExportResource(hako::Platform::Windows, path.c_str(), data);
+
+        hako::ResourcePathHash hash;
+        hako::GetResourcePathHash(path.c_str(), hash);
+        hashes.push_back(hash);
+    }
+
+    std::string const binarySearchArchive = (workingDirectory / "BinarySearch.hako").string();
+    std::string const lookupIndexArchive = (workingDirectory / "LookupIndex.hako").string();
+    std::string const compactBinarySearchArchive = (workingDirectory / "CompactBinarySearch.hako").string();
+    std::string const compactLookupIndexArchive = (workingDirectory / "CompactLookupIndex.hako").string();
+
+    hako::ArchiveCreationSettings settings;
+    hako::CreateArchive(hako::Platform::Windows, binarySearchArchive.c_str(), true, settings);
+    settings.m_WriteLookupIndex = true;
+    hako::CreateArchive(hako::Platform::Windows, lookupIndexArchive.c_str(), true, settings);
+    settings.m_Allow64BitHashes = true;
+    settings.m_Allow32BitOffsets = true;
+    hako::CreateArchive(hako::Platform::Windows, compactLookupIndexArchive.c_str(), true, settings);
+    settings.m_WriteLookupIndex = false;
+    hako::CreateArchive(hako::Platform::Windows, compactBinarySearchArchive.c_str(), true, settings);
+
+    std::mt19937_64 random(1234);
+    std::vector<hako::ResourcePathHash> lookups(lookupCount);
+    for (hako::ResourcePathHash& lookup : lookups)
+    {
+        lookup = hashes[random() % hashes.size()];
+    }
+
+    printf("%zu files, %zu lookups\n", fileCount, lookupCount);
+    printf("Binary search: %.1f ns per lookup\n", TimeLookups(binarySearchArchive.c_str(), lookups));
+    printf("Lookup index:  %.1f ns per lookup\n", TimeLookups(lookupIndexArchive.c_str(), lookups));
+    printf("Binary search (compact table of contents): %.1f ns per lookup\n", TimeLookups(compactBinarySearchArchive.c_str(), lookups));
+    printf("Lookup index (compact table of contents):  %.1f ns per lookup\n", TimeLookups(compactLookupIndexArchive.c_str(), lookups));
+
+    std::filesystem::remove_all(workingDirectory);
+    return 0;
+}
@@ -0,0 +1,41 @@
+# hako_embed_archive(<target> ARCHIVE <archive_path> NAME <function_name>)
+#
+# Compiles a Hako archive into <target>, so it can be opened with Archive::OpenFromMemory() without any file I/O.
+# Generates a header named <function_name>.h that declares
+#     hako::Span<char const> <function_name>();
+# which returns the archive's content. The archive is re-embedded whenever it changes, so it may be the output of a custom command.
+#
+# Example:
+#     hako_embed_archive(Game ARCHIVE ${CMAKE_BINARY_DIR}/Boot.hako NAME GetBootArchive)
+#
+#     #include <GetBootArchive.h>
+#     archive.OpenFromMemory(GetBootArchive());
+
+# Cached, so the script can be found when the function is called from another directory scope
+set(HAKO_EMBED_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/HakoEmbedArchive.cmake CACHE INTERNAL "")
+
+function(hako_embed_archive TARGET)
+    cmake_parse_arguments(EMBED "" "ARCHIVE;NAME" "" ${ARGN})
+
+    if(NOT EMBED_ARCHIVE OR NOT EMBED_NAME)
+        message(FATAL_ERROR "hako_embed_archive requires both ARCHIVE and NAME")
+    endif()
+
+    get_filename_component(EMBED_ARCHIVE ${EMBED_ARCHIVE} ABSOLUTE)
+
+    set(EMBED_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}/HakoEmbed)
+    set(EMBED_SOURCE ${EMBED_DIRECTORY}/${EMBED_NAME}.cpp)
+    set(EMBED_HEADER ${EMBED_DIRECTORY}/${EMBED_NAME}.h)
+
+    add_custom_command(
+        OUTPUT ${EMBED_SOURCE} ${EMBED_HEADER}
+        COMMAND ${CMAKE_COMMAND} -DINPUT=${EMBED_ARCHIVE} -DSOURCE=${EMBED_SOURCE} -DHEADER=${EMBED_HEADER} -DNAME=${EMBED_NAME} -P ${HAKO_EMBED_SCRIPT}
+        DEPENDS ${EMBED_ARCHIVE} ${HAKO_EMBED_SCRIPT}
+        COMMENT "Embedding Hako archive ${EMBED_ARCHIVE}"
+        VERBATIM
+    )
+
+    target_sources(${TARGET} PRIVATE ${EMBED_SOURCE} ${EMBED_HEADER})
+    target_include_directories(${TARGET} PRIVATE ${EMBED_DIRECTORY})
+    target_link_libraries(${TARGET} PRIVATE Hako)
+endfunction()
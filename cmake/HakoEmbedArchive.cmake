@@ -0,0 +1,35 @@
+# Script run by hako_embed_archive() at build time. Writes a source file that holds the content of INPUT, and a header that declares NAME().
+
+file(READ ${INPUT} ARCHIVE_HEX HEX)
+string(LENGTH "${ARCHIVE_HEX}" ARCHIVE_HEX_LENGTH)
+math(EXPR ARCHIVE_SIZE "${ARCHIVE_HEX_LENGTH} / 2")
+
+# Turn the hex string into an initializer list with 32 bytes per line. CMake's regular expressions don't support repetition counts, so the line pattern is spelled out.
+set(LINE_PATTERN "")
+foreach(BYTE_INDEX RANGE 31)
+    string(APPEND LINE_PATTERN "[0-9a-f][0-9a-f]")
+endforeach()
+
+string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n    " ARCHIVE_BYTES "${ARCHIVE_HEX}")
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "'\\\\x\\1'," ARCHIVE_BYTES "${ARCHIVE_BYTES}")
+
+file(WRITE ${HEADER} "#pragma once
+
+#include <Hako/Span.h>
+
+/** Content of the embedded Hako archive ${INPUT} */
+hako::Span<char const> ${NAME}();
+")
+
+# Archives are aligned like relocatable blobs, so views into them can be used in place
+file(WRITE ${SOURCE} "#include \"${NAME}.h\"
+
+alignas(16) static char const s_ArchiveData[${ARCHIVE_SIZE} + 1] = {
+    ${ARCHIVE_BYTES}
+};
+
+hako::Span<char const> ${NAME}()
+{
+    return { s_ArchiveData, ${ARCHIVE_SIZE} };
+}
+")
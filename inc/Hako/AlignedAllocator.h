@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace hako
+{
+    /**
+     * Allocator that aligns every allocation to a fixed alignment, e.g. DirectFile::DirectIOAlignment, so DirectFile can read into the memory without a bounce buffer
+     * @tparam T The type of the allocated elements
+     * @tparam Alignment The alignment of every allocation in bytes. Must be a power of two.
+     */
+    template<typename T, size_t Alignment>
+    class AlignedAllocator
+    {
+        static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    public:
+        using value_type = T;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+    public:
+        AlignedAllocator() = default;
+
+        template<typename U>
+        AlignedAllocator(AlignedAllocator<U, Alignment> const&) noexcept
+        { }
+
+        T* allocate(size_t a_Count)
+        {
+            return static_cast<T*>(::operator new(a_Count * sizeof(T), std::align_val_t{ Alignment }));
+        }
+
+        void deallocate(T* a_Pointer, size_t) noexcept
+        {
+            ::operator delete(a_Pointer, std::align_val_t{ Alignment });
+        }
+
+        template<typename U>
+        bool operator==(AlignedAllocator<U, Alignment> const&) const noexcept
+        {
+            return true;
+        }
+
+        template<typename U>
+        bool operator!=(AlignedAllocator<U, Alignment> const&) const noexcept
+        {
+            return false;
+        }
+    };
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Hako.h"
+
+#include <memory>
+#include <vector>
+
+namespace hako
+{
+    /**
+     * Sequential reader for a single file in an archive.
+     * Reads go to the archive on demand, so large files can be consumed incrementally. For compressed files, at most one decompressed chunk and the file's chunk table are kept in memory.
+     * @note A stream may only be used from one thread at a time, and may not outlive the archive it reads from.
+     */
+    class ArchiveFileStream final
+    {
+    public:
+        /**
+         * @param a_Archive The archive to read from
+         * @param a_ResourcePathHash The hash of the file to read
+         */
+        ArchiveFileStream(Archive const& a_Archive, ResourcePathHash const& a_ResourcePathHash);
+        ~ArchiveFileStream();
+
+        ArchiveFileStream(ArchiveFileStream&) = delete;
+        ArchiveFileStream(ArchiveFileStream const&) = delete;
+        ArchiveFileStream& operator=(ArchiveFileStream const&) = delete;
+        ArchiveFileStream(ArchiveFileStream&&) = default;
+        ArchiveFileStream& operator=(ArchiveFileStream&&) = default;
+
+        /**
+         * @return True if the file was found and can be read from
+         */
+        bool IsValid() const
+        {
+            return m_IsValid;
+        }
+
+        /**
+         * Read the next part of the file and advance the stream
+         * @param a_OutBuffer The buffer to read data into. Should be at least a_NumBytes in size.
+         * @param a_NumBytes The maximum number of bytes to read
+         * @return The number of bytes read. Less than a_NumBytes if the end of the file was reached or an error occurred.
+         */
+        size_t Read(char* a_OutBuffer, size_t a_NumBytes);
+
+        /**
+         * Move the stream to a different position in the file
+         * @param a_Position The offset from the start of the file's content
+         * @return True if the position lies within the file
+         */
+        bool Seek(size_t a_Position);
+
+        /**
+         * @return The stream's offset from the start of the file's content
+         */
+        size_t GetPosition() const
+        {
+            return m_Position;
+        }
+
+        /**
+         * @return The size of the file's content (in bytes)
+         */
+        size_t GetSize() const
+        {
+            return m_Size;
+        }
+
+        /**
+         * @return True if the whole file has been read
+         */
+        bool IsAtEnd() const
+        {
+            return m_Position >= m_Size;
+        }
+
+    private:
+        /**
+         * Read from the file at the stream's current position without advancing it
+         * @return The number of bytes read
+         */
+        size_t ReadAtPosition(char* a_OutBuffer, size_t a_NumBytes);
+
+    private:
+        Archive const* m_Archive = nullptr;
+        Archive::FileInfo m_FileInfo{};
+        /** The file to read from instead of the archive if the file was updated outside of the archive */
+        std::unique_ptr<IFile> m_FileOutsideArchive = nullptr;
+
+        size_t m_Size = 0;
+        size_t m_Position = 0;
+        bool m_IsValid = false;
+
+        /** The file's chunk table, if the file is compressed */
+        Archive::ReadBuffer m_ChunkTable{};
+        /** The last decompressed chunk, so reads that don't line up with chunks only decompress each chunk once */
+        std::vector<char> m_ChunkData{};
+        size_t m_ChunkDataIndex = static_cast<size_t>(-1);
+    };
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "Hako.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace hako
+{
+    /**
+     * A set of archives that are read from as if they were a single archive, e.g. a base game archive with DLC and patch archives on top of it.
+     * If multiple archives contain the same file, the file is read from the archive with the highest priority. Archives with the same priority are overridden by the one that was mounted last.
+     * Reads go through the content cache, access trace and statistics of the archive the file is read from.
+     * All mounted files are kept in a single merged index, so finding a file takes one lookup regardless of how many archives are mounted.
+     * Archives can be mounted and unmounted while other threads read from the set. Readers never wait for (un)mounts: each (un)mount publishes a new index, and reads that already started finish with the index they started with.
+     */
+    class ArchiveSet final
+    {
+    public:
+        ArchiveSet();
+        ~ArchiveSet();
+
+        ArchiveSet(ArchiveSet&) = delete;
+        ArchiveSet(ArchiveSet const&) = delete;
+        ArchiveSet& operator=(ArchiveSet const&) = delete;
+        ArchiveSet(ArchiveSet&&) = delete;
+        ArchiveSet& operator=(ArchiveSet&&) = delete;
+
+        /**
+         * Mount an archive. The archive may not be closed or reopened while it is mounted.
+         * Takes time linear in the number of files that are mounted, as the merged index is copied.
+         * @param a_Archive The archive to mount. Must already be opened.
+         * @param a_Priority The archive's priority. Files in archives with a higher priority override files in archives with a lower priority.
+         * @return True if the archive was mounted, false if it is not open or was already mounted
+         */
+        bool Mount(std::shared_ptr<Archive const> a_Archive, int32_t a_Priority = 0);
+
+        /**
+         * Unmount an archive. The archive stays alive until reads that are still using it finish.
+         * @param a_Archive The archive to unmount
+         * @return True if the archive was mounted
+         */
+        bool Unmount(Archive const& a_Archive);
+
+        /**
+         * Unmount all archives
+         */
+        void UnmountAll();
+
+        /**
+         * @return The number of archives that are currently mounted
+         */
+        size_t GetMountedArchiveCount() const;
+
+        /**
+         * @param a_ResourcePathHash The hash of the file to look for
+         * @return True if any of the mounted archives contains the file
+         */
+        bool HasFile(ResourcePathHash const& a_ResourcePathHash) const;
+
+        /**
+         * Get the size of a file, e.g. to allocate a buffer for ReadFile()
+         * @param a_ResourcePathHash The hash of the file
+         * @return The size of the file's content (in bytes), or 0 if the file could not be found
+         */
+        size_t GetFileSize(ResourcePathHash const& a_ResourcePathHash) const;
+
+        /**
+         * Read the content of a file from the archive with the highest priority that contains it
+         * @param a_FileName The file to read
+         * @param a_OutData The vector to read data into
+         * @return True if the file was successfully read
+         */
+        bool ReadFile(char const* a_FileName, std::vector<char>& a_OutData) const;
+
+        /**
+         * Read the content of a file from the archive with the highest priority that contains it
+         * @param a_ResourcePathHash The hash of the file to read
+         * @param a_OutData The vector to read data into
+         * @return True if the file was successfully read
+         */
+        bool ReadFile(ResourcePathHash const& a_ResourcePathHash, std::vector<char>& a_OutData) const;
+
+        /**
+         * Read the content of a file from the archive with the highest priority that contains it into a caller-provided buffer
+         * @param a_ResourcePathHash The hash of the file to read
+         * @param a_OutBuffer The buffer to read data into
+         * @param a_BufferSize The size of a_OutBuffer. Should be at least GetFileSize(a_ResourcePathHash) bytes.
+         * @return True if the file was successfully read
+         */
+        bool ReadFile(ResourcePathHash const& a_ResourcePathHash, char* a_OutBuffer, size_t a_BufferSize) const;
+
+        /**
+         * Read part of a file's content from the archive with the highest priority that contains it
+         * @param a_ResourcePathHash The hash of the file to read
+         * @param a_Offset The offset from the start of the file's content at which to start reading
+         * @param a_NumBytes The number of bytes to read. a_Offset + a_NumBytes may not exceed the size of the file.
+         * @param a_OutBuffer The buffer to read data into. Should be at least a_NumBytes in size.
+         * @return True if the range was successfully read
+         */
+        bool ReadRange(ResourcePathHash const& a_ResourcePathHash, size_t a_Offset, size_t a_NumBytes, char* a_OutBuffer) const;
+
+        /**
+         * Get a read-only view of a file's content without copying it (see Archive::ReadFileView())
+         * @note The view stays valid until the archive that contains the file is destroyed, which can happen when it is unmounted.
+         * @param a_ResourcePathHash The hash of the file to view
+         * @return A view of the file's content, or an empty span if the file could not be found or can't be viewed
+         */
+        Span<char const> ReadFileView(ResourcePathHash const& a_ResourcePathHash) const;
+
+    private:
+        struct MountedArchive
+        {
+            std::shared_ptr<Archive const> m_Archive = nullptr;
+            int32_t m_Priority = 0;
+        };
+
+        struct IndexEntry
+        {
+            Archive const* m_Archive = nullptr;
+            /** Index of the file in the archive's table of contents */
+            size_t m_FileIndex = 0;
+            /** Priority the archive was mounted with */
+            int32_t m_Priority = 0;
+        };
+
+        struct FoundFile
+        {
+            Archive const* m_Archive = nullptr;
+            Archive::FileInfo m_FileInfo{};
+        };
+
+        /**
+         * Immutable snapshot of the mounted archives. Owns the archives, so they outlive every read that uses the snapshot.
+         */
+        struct Index
+        {
+            /** Mounted archives, from lowest to highest priority */
+            std::vector<MountedArchive> m_Mounts;
+            /** Files keyed by the first 64 bits of their hash, which is all that archives with 64-bit hashes store */
+            std::unordered_map<uint64_t, IndexEntry> m_Files;
+        };
+
+        /**
+         * Build an index from scratch, e.g. after an archive was unmounted
+         * @param a_Mounts The archives to index, from lowest to highest priority
+         * @return The new index
+         */
+        static std::shared_ptr<Index> BuildIndex(std::vector<MountedArchive> a_Mounts);
+
+        /**
+         * Add a mounted archive's files to an index. Files that are already indexed are only overridden if their archive's priority is not higher.
+         * @param a_Index The index to add the files to
+         * @param a_Mount The archive to add the files of. Must be the archive that was mounted last among archives with its priority.
+         */
+        static void AddToIndex(Index& a_Index, MountedArchive const& a_Mount);
+
+        /**
+         * Publish a new index, so new reads use it. Expects m_MountMutex to be locked.
+         * @param a_Index The index to publish
+         */
+        void PublishIndex(std::shared_ptr<Index const> a_Index);
+
+        /**
+         * @return The index that is currently published
+         */
+        std::shared_ptr<Index const> GetIndex() const;
+
+        /**
+         * Find the archive a file should be read from
+         * @param a_Index The index to search
+         * @param a_ResourcePathHash The hash of the file to find
+         * @return The archive that contains the file and info on the file, or an empty optional if no mounted archive contains the file
+         */
+        static std::optional<FoundFile> FindFile(Index const& a_Index, ResourcePathHash const& a_ResourcePathHash);
+
+    private:
+        /** The current index. Only accessed through std::atomic_load and std::atomic_store. */
+        std::shared_ptr<Index const> m_Index = nullptr;
+        /** Serializes mounts and unmounts */
+        std::mutex m_MountMutex;
+    };
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace hako
+{
+    /**
+     * Allocator adaptor that default-initializes elements instead of value-initializing them, so resizing e.g. a std::vector<char> doesn't zero-fill the new elements.
+     * Use it to read files into vectors without paying for a memset, e.g. std::vector<char, DefaultInitAllocator<char, std::pmr::polymorphic_allocator<char>>> for an arena-backed buffer.
+     * @tparam T The type of the allocated elements
+     * @tparam Allocator The allocator to allocate memory with
+     */
+    template<typename T, typename Allocator = std::allocator<T>>
+    class DefaultInitAllocator : public Allocator
+    {
+        using Traits = std::allocator_traits<Allocator>;
+
+    public:
+        template<typename U>
+        struct rebind
+        {
+            using other = DefaultInitAllocator<U, typename Traits::template rebind_alloc<U>>;
+        };
+
+    public:
+        using Allocator::Allocator;
+
+        DefaultInitAllocator() = default;
+
+        DefaultInitAllocator(Allocator const& a_Allocator) noexcept
+            : Allocator(a_Allocator)
+        { }
+
+        template<typename U, typename OtherAllocator>
+        DefaultInitAllocator(DefaultInitAllocator<U, OtherAllocator> const& a_Other) noexcept
+            : Allocator(static_cast<OtherAllocator const&>(a_Other))
+        { }
+
+        /**
+         * Default-initialize an element, which leaves trivial types such as char uninitialized
+         */
+        template<typename U>
+        void construct(U* a_Pointer) noexcept(std::is_nothrow_default_constructible_v<U>)
+        {
+            ::new (static_cast<void*>(a_Pointer)) U;
+        }
+
+        template<typename U, typename... Args>
+        void construct(U* a_Pointer, Args&&... a_Args)
+        {
+            Traits::construct(static_cast<Allocator&>(*this), a_Pointer, std::forward<Args>(a_Args)...);
+        }
+    };
+}
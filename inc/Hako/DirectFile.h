@@ -0,0 +1,50 @@
+#pragma once
+
+#include "IFile.h"
+
+#include <string>
+
+#if defined(__linux__)
+// Read with O_DIRECT, which bypasses the page cache
+#define HAKO_DIRECT_FILE_IO
+#endif
+
+#if defined(HAKO_DIRECT_FILE_IO)
+namespace hako
+{
+    /**
+     * Read-only file that bypasses the OS page cache, so large streaming reads don't evict other data from it.
+     * Reads go straight into the caller's buffer when both the buffer and the offset are aligned to DirectIOAlignment, and through a per-thread aligned bounce buffer otherwise.
+     * Archive reads into its own buffers aligned to DirectIOAlignment. Callers can skip the bounce buffer too by reading into aligned memory, e.g. a vector with an AlignedAllocator.
+     * Archives created with ArchiveCreationSettings::m_EntryAlignment set to a multiple of DirectIOAlignment can have their files read without realigning.
+     */
+    class DirectFile final : public IFile
+    {
+    public:
+        /** Alignment that direct I/O requires for file offsets, buffer addresses and read sizes */
+        static constexpr size_t DirectIOAlignment = 4096;
+
+    public:
+        DirectFile() = default;
+        virtual ~DirectFile() override;
+
+        /**
+         * @return False if the file could not be opened, or the file system doesn't support direct I/O
+         */
+        bool Open(std::string const& a_FilePath);
+
+        virtual bool Read(size_t a_NumBytes, size_t a_Offset, std::vector<char>& a_Buffer) override;
+        virtual bool Read(size_t a_NumBytes, size_t a_Offset, char* a_Buffer) override;
+        virtual bool Write(size_t a_Offset, std::vector<char> const& a_Data) override;
+        virtual size_t GetFileSize() override;
+        virtual bool SupportsConcurrentReads() const override;
+        virtual bool Prefetch(size_t a_NumBytes, size_t a_Offset) override;
+
+    private:
+        void CloseFile();
+
+    private:
+        int m_FileDescriptor = -1;
+    };
+}
+#endif
@@ -1,11 +1,19 @@
 #pragma once
 
+#include "AlignedAllocator.h"
+#include "DefaultInitAllocator.h"
 #include "HakoPlatforms.h"
 #include "IFile.h"
+#include "RelocatableBlob.h"
+#include "ResourcePathHash.h"
 #include "Serializer.h"
 
+#include <atomic>
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -15,31 +23,49 @@ namespace hako
 
     using FileFactorySignature = std::function<std::unique_ptr<IFile>(char const* a_FilePath, FileOpenMode a_FileOpenMode)>;
 
-    struct ResourcePathHash
+    /**
+     * Compression applied to a file stored in an archive
+     */
+    enum class Compression : uint8_t
     {
-        static ResourcePathHash FromString(char const* a_Hash);
-        [[nodiscard]] std::string ToString() const;
-        /**
-         * @param a_OutBuffer Buffer is expected to be (at least) MaxResourcePathHashLength in length.
-         */
-        void ToString(char* a_OutBuffer) const;
-
-        bool operator==(ResourcePathHash const& a_Rhs) const
-        {
-            return hash64[0] == a_Rhs.hash64[0] && hash64[1] == a_Rhs.hash64[1];
-        }
-
-        bool operator!=(ResourcePathHash const& a_Rhs) const
-        {
-            return !(*this == a_Rhs);
-        }
+        None,
+        /** Hako's built-in LZ codec, applied to independently compressed chunks of the file */
+        LZ,
+        Count
+    };
 
-        bool operator<(ResourcePathHash const& a_Rhs) const;
-        bool operator<=(ResourcePathHash const& a_Rhs) const;
-        bool operator>(ResourcePathHash const& a_Rhs) const;
-        bool operator>=(ResourcePathHash const& a_Rhs) const;
+    /**
+     * A named set of files that are loaded together, e.g. everything needed to boot the game or to enter a level (see Archive::LoadGroup())
+     */
+    struct ArchiveLoadGroup
+    {
+        /** Name of the group, which is passed to Archive::LoadGroup() */
+        std::string m_Name{};
+        /** Paths of the group's resources, as passed to Archive::ReadFile(). A file can only belong to one group. */
+        std::vector<std::string> m_ResourcePaths{};
+    };
 
-        uint64_t hash64[2]{};
+    /**
+     * Settings that control how an archive is built
+     */
+    struct ArchiveCreationSettings
+    {
+        /** Compress files with Hako's built-in codec. Files that don't get smaller when compressed are stored uncompressed. */
+        bool m_CompressFiles = false;
+        /** Write a hash-bucketed lookup index, which lets archives find files in constant time instead of with a binary search */
+        bool m_WriteLookupIndex = false;
+        /** Alignment (in bytes) of the start of every archived file. Must be a power of two. Use e.g. 4096 to allow reading files with FileOpenMode::ReadDirect without realigning. */
+        size_t m_EntryAlignment = 1;
+        /** Path to an access trace recorded with Archive::StartAccessTrace(). When set, files are laid out in the order in which they were first accessed, followed by files that aren't in the trace. */
+        char const* m_AccessTracePath = nullptr;
+        /** Groups of files that are laid out contiguously, in the order in which they are listed, before all other files. The archive records the byte range of every group, so it can be read with a single read. */
+        std::vector<ArchiveLoadGroup> m_LoadGroups{};
+        /** Store only the first 64 bits of every hash in the table of contents, unless two files share them. Halves the memory the hashes take up, at the cost of lookups of files that aren't in the archive matching a file that shares the first 64 bits of their hash. */
+        bool m_Allow64BitHashes = false;
+        /** Store offsets and sizes in the table of contents as 32-bit values if the archive is guaranteed to stay below 4 GiB */
+        bool m_Allow32BitOffsets = false;
+        /** Number of threads that copy files into the archive. 0 uses one thread per hardware thread. Files are copied on a single thread if the archive's IFile doesn't support concurrent writes. */
+        size_t m_ThreadCount = 0;
     };
 
     /**
@@ -69,9 +95,10 @@ namespace hako
      * @param a_TargetPlatform The platform for which to create the archive
      * @param a_ArchiveName The name of the archive to output
      * @param a_OverwriteExistingFile If a file with the provided name already exists, a value of true will result in this file being overwritten
+     * @param a_Settings Settings that control how the archive is built
      * @return True if the archive was created successfully
      */
-    bool CreateArchive(Platform a_TargetPlatform, char const* a_ArchiveName, bool a_OverwriteExistingFile = false);
+    bool CreateArchive(Platform a_TargetPlatform, char const* a_ArchiveName, bool a_OverwriteExistingFile = false, ArchiveCreationSettings const& a_Settings = {});
 
     /**
      * Serialize a file or the content of a directory into the intermediate directory
@@ -97,25 +124,134 @@ namespace hako
      * Get a hash for a resource path or name
      * @param a_Path The path or name of the resource
      * @param a_OutHash The hash for a_Path (out)
+     * @note Use HAKO_RESOURCE or the _hako literal to hash paths that are known at compile time
      */
     void GetResourcePathHash(char const* a_Path, ResourcePathHash& a_OutHash);
 
+    /**
+     * Statistics for an archive's content cache (see Archive::SetContentCacheBudget())
+     */
+    struct ContentCacheStats
+    {
+        /** Number of reads that were served from the cache */
+        uint64_t m_HitCount = 0;
+        /** Number of reads that had to go to the archive while the cache was enabled */
+        uint64_t m_MissCount = 0;
+        /** Number of bytes of file content that is currently cached */
+        size_t m_CachedBytes = 0;
+        /** Number of files that are currently cached */
+        size_t m_CachedFileCount = 0;
+        /** Maximum number of bytes of file content the cache may hold */
+        size_t m_Budget = 0;
+    };
+
+    /**
+     * Distribution of operation latencies over power-of-two nanosecond buckets
+     */
+    struct LatencyHistogram
+    {
+        static constexpr size_t BucketCount = 32;
+
+        /**
+         * Estimate a percentile of the recorded latencies
+         * @param a_Percentile The percentile to estimate, from 0 to 100
+         * @return The upper bound (in nanoseconds) of the bucket that contains the percentile, or 0 if nothing was recorded
+         */
+        uint64_t GetPercentile(double a_Percentile) const;
+
+        /** Bucket i counts operations that took [2^i, 2^(i+1)) nanoseconds. The last bucket also counts all slower operations. */
+        uint64_t m_Buckets[BucketCount]{};
+        /** Number of recorded operations */
+        uint64_t m_Count = 0;
+        /** Sum of all recorded latencies, in nanoseconds */
+        uint64_t m_TotalNanoseconds = 0;
+    };
+
+    /**
+     * Read-path statistics of an archive (see Archive::GetStats()). Always zero when Hako is built with HAKO_NO_STATS.
+     */
+    struct ArchiveStats
+    {
+        /** Number of times a file was looked up in the table of contents */
+        uint64_t m_LookupCount = 0;
+        /** Number of lookups that didn't find the file */
+        uint64_t m_LookupMissCount = 0;
+        /** Number of files (or ranges of files) whose content was read from the archive */
+        uint64_t m_ReadCount = 0;
+        /** Number of bytes of file content that were read from the archive */
+        uint64_t m_BytesRead = 0;
+        /** Number of times a newer version of a file was found outside of the archive. Only used when reading outside of the archive. */
+        uint64_t m_OverlayHitCount = 0;
+        /** Time spent looking up files in the table of contents. Only a sample of all lookups is timed. */
+        LatencyHistogram m_LookupLatency;
+        /** Time spent reading and decompressing file content. Files that are read with a single coalesced read (see Archive::ReadFiles()) are recorded as one operation. */
+        LatencyHistogram m_ReadLatency;
+    };
+
+    class AccessTraceWriter;
+    class ArchiveFileStream;
+    class ArchiveSet;
+    class ArchiveStatistics;
+    class ContentCache;
+    class IntermediateOverlay;
+    class StreamingScheduler;
+    class TableOfContents;
+    class ThreadPool;
+
+    /**
+     * Read access to a Hako archive.
+     * All const member functions may be called concurrently from multiple threads on the same archive, as long as the archive isn't opened or closed at the same time.
+     * Reads are only serialized when the archive's IFile implementation doesn't support concurrent reads (see IFile::SupportsConcurrentReads()).
+     */
     class Archive final
     {
+        friend class ArchiveFileStream;
+        friend class ArchiveSet;
+        friend class StreamingScheduler;
+
     public:
+        /**
+         * Signature for a function that is called when an asynchronous read finishes. Called from one of the archive's I/O threads, so it must not close or destroy the archive.
+         * @param a_ResourcePathHash The hash of the file that was read
+         * @param a_Success True if the file was successfully read
+         * @param a_Data The file's content. The callback may move out of it.
+         */
+        using ReadFileCallback = std::function<void(ResourcePathHash const& a_ResourcePathHash, bool a_Success, std::vector<char>& a_Data)>;
+
+        /**
+         * Info on an archived file, as found in the archive's table of contents
+         */
         struct FileInfo
         {
             ResourcePathHash m_ResourcePathHash{};
-            char m_Padding[7]{};
+            Compression m_Compression = Compression::None;
+            char m_Padding[3]{};
+            /** CRC32C of the file's data as stored in the archive */
+            uint32_t m_Checksum = 0;
+            /** Size of the file's content (in bytes) */
             size_t m_Size = 0;
+            /** Offset of the file's data from the start of the archive */
+            size_t m_Offset = 0;
+            /** Number of bytes the file's data takes up in the archive. Differs from m_Size if the file is compressed. */
+            size_t m_StoredSize = 0;
+        };
+        static_assert(sizeof(FileInfo) == 48 && "FileInfo size changed");
+
+        struct LoadGroupInfo
+        {
+            /** Hash of the group's name */
+            ResourcePathHash m_NameHash{};
+            /** Offset of the data of the group's first file from the start of the archive */
             size_t m_Offset = 0;
+            /** Number of bytes from the start of the group's first file to the end of its last file */
+            size_t m_Size = 0;
         };
-        static_assert(sizeof(FileInfo) == 40 && "FileInfo size changed");
+        static_assert(sizeof(LoadGroupInfo) == 32 && "LoadGroupInfo size changed");
 
     public:
-        Archive() = default;
-        Archive(char const* a_ArchivePath, char const* a_IntermediateDirectory = nullptr, Platform a_Platform = Platform::Windows);
-        ~Archive() = default;
+        Archive();
+        Archive(char const* a_ArchivePath, char const* a_IntermediateDirectory = nullptr, Platform a_Platform = Platform::Windows, FileOpenMode a_OpenMode = FileOpenMode::Read);
+        ~Archive();
 
         Archive(Archive&) = delete;
         Archive(Archive const&) = delete;
@@ -128,13 +264,31 @@ namespace hako
          * @param a_ArchivePath The path to the archive to open
          * @param a_IntermediateDirectory The directory in which intermediate files are located. Overrides whatever directory was passed to SetIntermediateDirectory.
          * @param a_Platform The current platform. Used when intermediate file reading is enabled.
+         * @param a_OpenMode The mode to open the archive file with. Use FileOpenMode::ReadMapped to map the archive into memory, which enables ReadFileView(), or FileOpenMode::ReadDirect to bypass the OS page cache.
+         */
+        void Open(char const* a_ArchivePath, char const* a_IntermediateDirectory = nullptr, Platform a_Platform = Platform::Windows, FileOpenMode a_OpenMode = FileOpenMode::Read);
+
+        /**
+         * Open an archive that is already in memory, e.g. one that is embedded in the executable with hako_embed_archive() (see cmake/HakoEmbed.cmake).
+         * The archive is read like a mapped archive, so reads don't do any file I/O and ReadFileView() is available. Files are never read from outside of the archive.
+         * @param a_ArchiveData The archive's content. Must stay valid until the archive is closed.
          */
-        void Open(char const* a_ArchivePath, char const* a_IntermediateDirectory = nullptr, Platform a_Platform = Platform::Windows);
+        void OpenFromMemory(Span<char const> a_ArchiveData);
         /**
-         * Close the archive
+         * Close the archive. Waits for pending asynchronous reads to finish.
          */
         void Close();
 
+        /**
+         * @return True if an archive was successfully opened and has not been closed since
+         */
+        bool IsOpen() const;
+
+        /**
+         * @return True if the archive's table of contents only stores the first 64 bits of every hash (see ArchiveCreationSettings::m_Allow64BitHashes)
+         */
+        bool HasTruncatedHashes() const;
+
         /**
          * Read the content of an archived file from the archive
          * @param a_FileName The file to read from the archive
@@ -151,13 +305,311 @@ namespace hako
          */
         bool ReadFile(ResourcePathHash const& a_ResourcePathHash, std::vector<char>& a_OutData) const;
 
+        /**
+         * Read the content of an archived file from the archive into a caller-provided buffer
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_OutBuffer The buffer to read data into
+         * @param a_BufferSize The size of a_OutBuffer. Should be at least GetFileSize(a_ResourcePathHash) bytes.
+         * @return True if the file was successfully read
+         */
+        bool ReadFile(ResourcePathHash const& a_ResourcePathHash, char* a_OutBuffer, size_t a_BufferSize) const;
+
+        /**
+         * Read the content of an archived file from the archive into a vector with a custom allocator (e.g. a std::pmr::vector<char>)
+         * @note Resizing a vector zero-fills it, unless its allocator default-initializes elements. Use DefaultInitAllocator (e.g. around a std::pmr::polymorphic_allocator<char>) to read without a memset.
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_OutData The vector to read data into. It is resized to the file's size.
+         * @return True if the file was successfully read
+         */
+        template<typename Allocator>
+        bool ReadFile(ResourcePathHash const& a_ResourcePathHash, std::vector<char, Allocator>& a_OutData) const
+        {
+            return ReadFileIntoBuffer(a_ResourcePathHash, nullptr, [&a_OutData](size_t a_FileSize, char*& a_OutBuffer)
+                {
+                    a_OutData.resize(a_FileSize);
+                    a_OutBuffer = a_OutData.data();
+                    return true;
+                }
+            );
+        }
+
+        /**
+         * Read a relocatable blob (see RelocatableBlobWriter) and fix up its pointers in the read buffer, so its objects can be used without parsing them
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_OutData The vector to read the blob into. The blob's objects are valid until the vector is resized or destroyed.
+         * @return The blob's root object, or a nullptr if the file could not be read or is not a valid relocatable blob
+         */
+        void* ReadRelocatable(ResourcePathHash const& a_ResourcePathHash, std::vector<char>& a_OutData) const;
+
+        /**
+         * Read a relocatable blob (see RelocatableBlobWriter) into a caller-provided buffer and fix up its pointers in place
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_OutBuffer The buffer to read the blob into. Must be aligned to RelocatableBlobAlignment. The blob's objects are valid for as long as the buffer is.
+         * @param a_BufferSize The size of a_OutBuffer. Should be at least GetFileSize(a_ResourcePathHash) bytes.
+         * @return The blob's root object, or a nullptr if the file could not be read or is not a valid relocatable blob
+         */
+        void* ReadRelocatable(ResourcePathHash const& a_ResourcePathHash, char* a_OutBuffer, size_t a_BufferSize) const;
+
+        /**
+         * Read a relocatable blob (see RelocatableBlobWriter) and fix up its pointers in the read buffer
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_OutData The vector to read the blob into. The blob's objects are valid until the vector is resized or destroyed.
+         * @return The blob's root object, or a nullptr if the file could not be read or is not a valid relocatable blob
+         */
+        template<typename T>
+        T* ReadRelocatable(ResourcePathHash const& a_ResourcePathHash, std::vector<char>& a_OutData) const
+        {
+            return static_cast<T*>(ReadRelocatable(a_ResourcePathHash, a_OutData));
+        }
+
+        /**
+         * Get the size of an archived file, e.g. to allocate a buffer for ReadFile()
+         * @param a_ResourcePathHash The hash of the file
+         * @return The size of the file's content (in bytes), or 0 if the file could not be found
+         */
+        size_t GetFileSize(ResourcePathHash const& a_ResourcePathHash) const;
+
+        /**
+         * Read part of an archived file's content. Compressed files only have the chunks that overlap the range decompressed.
+         * Use ArchiveFileStream to read through a large file sequentially.
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_Offset The offset from the start of the file's content at which to start reading
+         * @param a_NumBytes The number of bytes to read. a_Offset + a_NumBytes may not exceed the size of the file.
+         * @param a_OutBuffer The buffer to read data into. Should be at least a_NumBytes in size.
+         * @return True if the range was successfully read
+         */
+        bool ReadRange(ResourcePathHash const& a_ResourcePathHash, size_t a_Offset, size_t a_NumBytes, char* a_OutBuffer) const;
+
+        /**
+         * Read part of an archived file's content. Compressed files only have the chunks that overlap the range decompressed.
+         * Use ArchiveFileStream to read through a large file sequentially.
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_Offset The offset from the start of the file's content at which to start reading
+         * @param a_NumBytes The number of bytes to read. a_Offset + a_NumBytes may not exceed the size of the file.
+         * @param a_OutData The vector to read data into
+         * @return True if the range was successfully read
+         */
+        bool ReadRange(ResourcePathHash const& a_ResourcePathHash, size_t a_Offset, size_t a_NumBytes, std::vector<char>& a_OutData) const;
+
+        /**
+         * Read the content of multiple archived files at once.
+         * Files are read in the order in which they are stored in the archive, and files that are (nearly) adjacent are read with a single read.
+         * @param a_ResourcePathHashes The hashes of the files to read from the archive
+         * @param a_OutData The vectors to read data into. Should contain as many elements as a_ResourcePathHashes, where a_OutData[i] receives the content of a_ResourcePathHashes[i].
+         * @return True if all files were successfully read
+         */
+        bool ReadFiles(Span<ResourcePathHash const> a_ResourcePathHashes, Span<std::vector<char>> a_OutData) const;
+
+        /**
+         * Read the content of an archived file on one of the archive's I/O threads
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_OutData The vector to read data into. Must stay alive until the returned future is ready.
+         * @return A future that becomes true if the file was successfully read
+         */
+        std::future<bool> ReadFileAsync(ResourcePathHash const& a_ResourcePathHash, std::vector<char>& a_OutData) const;
+
+        /**
+         * Read the content of an archived file on one of the archive's I/O threads
+         * @note The callback runs on one of the archive's I/O threads, so it must not close or destroy the archive, which waits for those threads to finish
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_Callback The function to call once the read finishes
+         */
+        void ReadFileAsync(ResourcePathHash const& a_ResourcePathHash, ReadFileCallback a_Callback) const;
+
+        /**
+         * Get a read-only view of an archived file's content without copying it
+         * @note Only available when the archive is mapped into memory (see FileOpenMode::ReadMapped) and the file is not compressed. The view stays valid until the archive is closed.
+         * @param a_FileName The file to view
+         * @return A view of the file's content, or an empty span if the file could not be found, is compressed, or the archive is not mapped into memory
+         */
+        Span<char const> ReadFileView(char const* a_FileName) const;
+
+        /**
+         * Get a read-only view of an archived file's content without copying it
+         * @note Only available when the archive is mapped into memory (see FileOpenMode::ReadMapped) and the file is not compressed. The view stays valid until the archive is closed.
+         * @param a_ResourcePathHash The hash of the file to view
+         * @return A view of the file's content, or an empty span if the file could not be found, is compressed, or the archive is not mapped into memory
+         */
+        Span<char const> ReadFileView(ResourcePathHash const& a_ResourcePathHash) const;
+
+        /**
+         * Start loading archived files into memory (e.g. the OS page cache) so later reads don't have to wait for storage. Does not block.
+         * Uses readahead hints where the archive's IFile supports them (see IFile::Prefetch()), and reads the files on one of the archive's I/O threads otherwise.
+         * @param a_ResourcePathHashes The hashes of the files that will be read soon. Files that can't be found are skipped.
+         */
+        void Prefetch(Span<ResourcePathHash const> a_ResourcePathHashes) const;
+
+        /**
+         * Hint that archived files won't be read for a while, so the memory they occupy outside of Hako (e.g. in the OS page cache) may be released
+         * @param a_ResourcePathHashes The hashes of the files. Files that can't be found are skipped.
+         */
+        void Evict(Span<ResourcePathHash const> a_ResourcePathHashes) const;
+
+        /**
+         * Set whether reads of whole files check the file's data against its checksum. Disabled by default.
+         * Reads of part of a file (ReadRange(), ArchiveFileStream) are never verified.
+         * @param a_VerifyChecksums True to verify checksums when reading files
+         */
+        void SetVerifyChecksums(bool a_VerifyChecksums);
+
+        /**
+         * Check an archived file's data against its checksum
+         * @param a_ResourcePathHash The hash of the file to verify
+         * @return True if the file was found and its data matches its checksum
+         */
+        bool VerifyFile(ResourcePathHash const& a_ResourcePathHash) const;
+
+        /**
+         * Check the data of every file in the archive against its checksum. Files are verified in parallel on all available cores.
+         * @param a_OutCorruptedFiles If not null, receives the hashes of all files that failed verification (out). Only the first 64 bits (hash64[0]) are set if the archive has truncated hashes (see HasTruncatedHashes()).
+         * @return True if all files match their checksums
+         */
+        bool VerifyArchive(std::vector<ResourcePathHash>* a_OutCorruptedFiles = nullptr) const;
+
+        /**
+         * Start recording which files are read from the archive, and when. Pass the trace to ArchiveCreationSettings::m_AccessTracePath to lay out the next archive in the order in which files are loaded.
+         * Replaces any trace that is already being recorded. Recording stops when StopAccessTrace() is called or the archive is closed.
+         * @param a_TracePath The path of the trace file to write. Overwritten if it exists.
+         * @return True if the trace file was created
+         */
+        bool StartAccessTrace(char const* a_TracePath);
+
+        /**
+         * Stop recording file accesses and finish writing the trace file
+         */
+        void StopAccessTrace();
+
+        /**
+         * Read all files of a load group (see ArchiveCreationSettings::m_LoadGroups) into memory with a single read. Until the group is unloaded, reads of its files are served from memory.
+         * Archives that are mapped into memory only prefetch the group's range, as their reads don't need any file I/O.
+         * @param a_GroupName The name of the group to load
+         * @return True if the group was loaded or already loaded
+         */
+        bool LoadGroup(char const* a_GroupName);
+
+        /**
+         * Read all files of a load group into memory with a single read (see LoadGroup(char const*))
+         * @param a_GroupNameHash The hash of the name of the group to load
+         * @return True if the group was loaded or already loaded
+         */
+        bool LoadGroup(ResourcePathHash const& a_GroupNameHash);
+
+        /**
+         * Release the memory held by a loaded group. Reads that are being served from the group finish first.
+         * @param a_GroupName The name of the group to unload
+         */
+        void UnloadGroup(char const* a_GroupName);
+
+        /**
+         * Release the memory held by a loaded group
+         * @param a_GroupNameHash The hash of the name of the group to unload
+         */
+        void UnloadGroup(ResourcePathHash const& a_GroupNameHash);
+
+        /**
+         * Set how many bytes of file content the archive may keep cached in memory. The cache is disabled (0 bytes) by default.
+         * While the cache is enabled, ReadFile() and ReadFileShared() serve recently read files from memory, evicting the least recently used files when the budget is exceeded.
+         * @param a_NumBytes The cache budget in bytes. A budget of 0 disables the cache and releases all cached files.
+         */
+        void SetContentCacheBudget(size_t a_NumBytes);
+
+        /**
+         * Read the content of an archived file into a buffer that can be shared between readers.
+         * If the content cache is enabled, the buffer is served from or added to the cache.
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @return The file's content, or a nullptr if the file could not be read
+         */
+        std::shared_ptr<std::vector<char> const> ReadFileShared(ResourcePathHash const& a_ResourcePathHash) const;
+
+        /**
+         * @return Statistics for the archive's content cache. Hit and miss counts are kept until the archive is destroyed.
+         */
+        ContentCacheStats GetContentCacheStats() const;
+
+        /**
+         * @return A snapshot of the archive's read-path statistics since it was created or ResetStats() was called
+         */
+        ArchiveStats GetStats() const;
+
+        /**
+         * Set all read-path statistics back to zero, e.g. at the start of a loading screen that should be measured
+         */
+        void ResetStats();
+
+    private:
+        /** Alignment of the buffers the archive reads into, so archives opened with FileOpenMode::ReadDirect read straight into them (see DirectFile::DirectIOAlignment) */
+        static constexpr size_t ReadBufferAlignment = 4096;
+        /** Buffer the archive reads into. Aligned for direct I/O, and not zero-filled when it is resized, as it is overwritten right away. */
+        using ReadBuffer = std::vector<char, DefaultInitAllocator<char, AlignedAllocator<char, ReadBufferAlignment>>>;
+
     private:
+        /**
+         * Read and validate the header, table of contents and lookup index of the archive that m_ArchiveReader was opened for. Closes the archive if any of them are invalid.
+         */
+        void ReadTableOfContents();
+
+        /**
+         * Check that all files in the table of contents lie within the archive, use a known compression method and are sorted by hash.
+         * Done once when opening the archive, so reads don't have to check bounds.
+         * @param a_ArchiveSize The size of the archive (in bytes)
+         * @return True if the table of contents is valid
+         */
+        bool ValidateTableOfContents(size_t a_ArchiveSize) const;
+
+        /**
+         * Read and validate the archive's lookup index. Expects the table of contents to be loaded already.
+         * @param a_Offset The offset of the lookup index from the start of the archive
+         * @param a_BucketBits The number of leading hash bits that select a bucket
+         * @param a_ArchiveSize The size of the archive (in bytes)
+         * @return True if the lookup index is valid
+         */
+        bool ReadLookupIndex(size_t a_Offset, uint8_t a_BucketBits, size_t a_ArchiveSize);
+
+        /**
+         * Read and validate the archive's load group table
+         * @param a_Offset The offset of the load group table from the start of the archive
+         * @param a_GroupCount The number of groups in the table
+         * @param a_ArchiveSize The size of the archive (in bytes)
+         * @return True if the load group table is valid
+         */
+        bool ReadLoadGroupTable(size_t a_Offset, uint32_t a_GroupCount, size_t a_ArchiveSize);
+
+        /**
+         * Find the info of a load group
+         * @param a_GroupNameHash The hash of the group's name
+         * @return The group's info, or a nullptr if the archive has no such group
+         */
+        LoadGroupInfo const* FindLoadGroupInfo(ResourcePathHash const& a_GroupNameHash) const;
+
+        /**
+         * Get a file's stored data if it is already in memory, because the archive is mapped or the file belongs to a loaded group
+         * @param a_FileInfo The file info for the file
+         * @param a_OutGroupData Keeps the loaded group's data alive while the returned data is used (out)
+         * @return The file's stored data, or a nullptr if it has to be read from the archive
+         */
+        char const* GetStoredData(FileInfo const& a_FileInfo, std::shared_ptr<ReadBuffer const>& a_OutGroupData) const;
+
         /**
          * Get the FileInfo for a specific file
          * @param a_ResourcePathHash The file to find file info for
-         * @return The file info, or a nullptr if not found
+         * @return The file info, or nothing if not found
+         */
+        std::optional<FileInfo> GetFileInfo(ResourcePathHash const& a_ResourcePathHash) const;
+
+        /**
+         * Get the FileInfo for a specific file, unless the caller already looked it up
+         * @param a_ResourcePathHash The file to find file info for
+         * @param a_FileInfo The file info if the caller already looked the file up (e.g. ArchiveSet), or a nullptr to look it up in the table of contents
+         * @return The file info, or nothing if not found
          */
-        FileInfo const* GetFileInfo(ResourcePathHash const& a_ResourcePathHash) const;
+        std::optional<FileInfo> GetFileInfo(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo) const;
+
+        /**
+         * Find the FileInfo for a specific file without recording the lookup in the archive's statistics
+         * @param a_ResourcePathHash The file to find file info for
+         * @return The file info, or nothing if not found
+         */
+        std::optional<FileInfo> FindFileInfo(ResourcePathHash const& a_ResourcePathHash) const;
 
         /**
          * Read a file outside of the archive as if it was placed inside the archive.
@@ -167,6 +619,20 @@ namespace hako
          */
         bool ReadFileOutsideArchive(ResourcePathHash const& a_Hash, std::vector<char>& a_OutData) const;
 
+        /**
+         * Open a file outside of the archive if it was updated since the archive was created
+         * @param a_Hash The hash of the file to open
+         * @return The opened file, or a nullptr if the file should be read from the archive instead
+         */
+        std::unique_ptr<IFile> OpenFileOutsideArchive(ResourcePathHash const& a_Hash) const;
+
+        /**
+         * Check if a file was updated outside of the archive since the archive was created
+         * @param a_Hash The hash of the file to check
+         * @return True if the intermediate file is newer than the archive
+         */
+        bool HasNewerFileOutsideArchive(ResourcePathHash const& a_Hash) const;
+
         /**
          * Read the content of an archived file from the archive that is currently open
          * @param a_FileInfo The file info for the file that should be loaded
@@ -175,14 +641,205 @@ namespace hako
          */
         bool LoadFileContent(FileInfo const& a_FileInfo, std::vector<char>& a_Data) const;
 
+        /**
+         * Read the content of an archived file from the archive that is currently open into a caller-provided buffer
+         * @param a_FileInfo The file info for the file that should be loaded
+         * @param a_Buffer The buffer to read data into. Should be at least a_FileInfo.m_Size bytes.
+         * @return True if the file was successfully read
+         */
+        bool LoadFileContent(FileInfo const& a_FileInfo, char* a_Buffer) const;
+
+        /**
+         * Read part of an archived file's content from the archive that is currently open
+         * @param a_FileInfo The file info for the file that should be read from
+         * @param a_Offset The offset from the start of the file's content at which to start reading
+         * @param a_NumBytes The number of bytes to read. The range is expected to lie within the file.
+         * @param a_Buffer The buffer to read data into. Should be at least a_NumBytes in size.
+         * @param a_ChunkTable The file's chunk table if the file is compressed and the caller already loaded it (see ReadChunkTable()). Read from the archive if not provided.
+         * @return True if the range was successfully read
+         */
+        bool LoadFileRange(FileInfo const& a_FileInfo, size_t a_Offset, size_t a_NumBytes, char* a_Buffer, char const* a_ChunkTable = nullptr) const;
+
+        /**
+         * Read part of an archived file's content without recording the read in the archive's statistics (see LoadFileRange())
+         */
+        bool ReadFileRange(FileInfo const& a_FileInfo, size_t a_Offset, size_t a_NumBytes, char* a_Buffer, char const* a_ChunkTable) const;
+
+        /**
+         * Check a file's data against its checksum, reading the data in chunks
+         * @param a_FileInfo The file info for the file to verify
+         * @param a_ScratchBuffer Buffer to read the file's data into
+         * @param a_IsHashTruncated True if a_FileInfo's hash was read from a table of contents that only stores the first 64 bits of every hash, so only those are logged
+         * @return True if the file's data matches its checksum
+         */
+        bool VerifyFileContent(FileInfo const& a_FileInfo, ReadBuffer& a_ScratchBuffer, bool a_IsHashTruncated) const;
+
+        /**
+         * Read the chunk table of a compressed file
+         * @param a_FileInfo The file info for the compressed file
+         * @param a_OutChunkTable The vector to read the chunk table into
+         * @return True if the chunk table was successfully read
+         */
+        bool ReadChunkTable(FileInfo const& a_FileInfo, ReadBuffer& a_OutChunkTable) const;
+
+        /**
+         * Read a range of bytes from the archive that is currently open
+         * @param a_NumBytes The number of bytes to read
+         * @param a_Offset The offset from the start of the archive to read from
+         * @param a_Data The vector to read data into. Resized to a_NumBytes.
+         * @return True if the range was successfully read
+         */
+        bool ReadArchiveRange(size_t a_NumBytes, size_t a_Offset, ReadBuffer& a_Data) const;
+
+        /**
+         * Read a range of bytes from the archive that is currently open into a caller-provided buffer
+         * @param a_NumBytes The number of bytes to read
+         * @param a_Offset The offset from the start of the archive to read from
+         * @param a_Buffer The buffer to read data into. Should be at least a_NumBytes bytes.
+         * @return True if the range was successfully read
+         */
+        bool ReadArchiveRange(size_t a_NumBytes, size_t a_Offset, char* a_Buffer) const;
+
+        /**
+         * Provides the buffer a file is read into once the file's size is known
+         * @param a_FileSize The size of the file in bytes
+         * @param a_OutBuffer Receives a buffer of at least a_FileSize bytes (out)
+         * @return False if no buffer can be provided, which fails the read
+         */
+        using GetReadBufferFunction = std::function<bool(size_t a_FileSize, char*& a_OutBuffer)>;
+
+        /**
+         * Read the content of a file into a buffer that is only requested once the file's size is known, so the file is only looked up once
+         * @param a_ResourcePathHash The hash of the file to read
+         * @param a_FileInfo The file info if the caller already looked the file up, or a nullptr to look it up in the table of contents
+         * @param a_GetBuffer Called once with the file's size before the file is read
+         * @return True if the file was successfully read
+         */
+        bool ReadFileIntoBuffer(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo, GetReadBufferFunction const& a_GetBuffer) const;
+
+        /**
+         * Read the content of an archived file like ReadFile(), through the content cache, access trace and statistics
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_FileInfo The file info if the caller already looked the file up (e.g. ArchiveSet), or a nullptr to look it up in the table of contents
+         * @param a_OutData The vector to read data into
+         * @return True if the file was successfully read
+         */
+        bool ReadFile(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo, std::vector<char>& a_OutData) const;
+
+        /**
+         * Read the content of an archived file into a caller-provided buffer like ReadFile()
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_FileInfo The file info if the caller already looked the file up, or a nullptr to look it up in the table of contents
+         * @param a_OutBuffer The buffer to read data into
+         * @param a_BufferSize The size of a_OutBuffer
+         * @return True if the file was successfully read
+         */
+        bool ReadFile(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo, char* a_OutBuffer, size_t a_BufferSize) const;
+
+        /**
+         * Read part of an archived file's content like ReadRange()
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_FileInfo The file info if the caller already looked the file up, or a nullptr to look it up in the table of contents
+         * @param a_Offset The offset from the start of the file's content at which to start reading
+         * @param a_NumBytes The number of bytes to read
+         * @param a_OutBuffer The buffer to read data into
+         * @return True if the range was successfully read
+         */
+        bool ReadRange(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo, size_t a_Offset, size_t a_NumBytes, char* a_OutBuffer) const;
+
+        /**
+         * Get a read-only view of an archived file's content like ReadFileView()
+         * @param a_ResourcePathHash The hash of the file to view
+         * @param a_FileInfo The file info if the caller already looked the file up, or a nullptr to look it up in the table of contents
+         * @return A view of the file's content, or an empty span if the file can't be viewed
+         */
+        Span<char const> ReadFileView(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo) const;
+
+        /**
+         * Read the content of a file into a shared buffer like ReadFileShared()
+         * @param a_ResourcePathHash The hash of the file to read
+         * @param a_FileInfo The file info if the caller already looked the file up, or a nullptr to look it up in the table of contents
+         * @return The file's content, or a nullptr if the file could not be read
+         */
+        std::shared_ptr<std::vector<char> const> ReadFileShared(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo) const;
+
+        /**
+         * Read the content of an archived file into a new shared buffer, bypassing the content cache and files outside of the archive
+         * @param a_ResourcePathHash The hash of the file to read from the archive
+         * @param a_FileInfo The file info if the caller already looked the file up, or a nullptr to look it up in the table of contents
+         * @return The file's content, or a nullptr if the file could not be read
+         */
+        std::shared_ptr<std::vector<char> const> LoadFileShared(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo) const;
+
+        /**
+         * Get the ranges of the archive that hold the data of a set of files, sorted by offset. Files that are close together share a range.
+         * @param a_ResourcePathHashes The hashes of the files
+         * @return (offset, size) pairs for every range. Files that can't be found are skipped.
+         */
+        std::vector<std::pair<size_t, size_t>> GetArchiveRanges(Span<ResourcePathHash const> a_ResourcePathHashes) const;
+
+        /**
+         * Add a file access to the access trace, if one is being recorded
+         * @param a_ResourcePathHash The hash of the file that is read
+         */
+        void RecordAccess(ResourcePathHash const& a_ResourcePathHash) const;
+
+        /**
+         * Get the thread pool used for asynchronous reads, creating it if needed
+         */
+        ThreadPool& GetIOThreadPool() const;
+
+    private:
+        struct LoadedGroup
+        {
+            ResourcePathHash m_NameHash{};
+            size_t m_Offset = 0;
+            std::shared_ptr<ReadBuffer const> m_Data = nullptr;
+        };
+
     private:
         /** Info on all files present in the archive opened with OpenArchive() */
-        std::vector<FileInfo> m_FilesInArchive;
+        std::unique_ptr<TableOfContents> m_TableOfContents;
+        /** First file of each lookup index bucket, or empty if the archive has no lookup index */
+        std::vector<uint32_t> m_LookupIndex;
+        /** Number of leading hash bits that select a lookup index bucket */
+        uint8_t m_LookupIndexBucketBits = 0;
         /** The instance of FileIO that is currently being used to read from the archive */
         std::unique_ptr<IFile> m_ArchiveReader = nullptr;
+        /** The archive's content if m_ArchiveReader mapped it into memory */
+        Span<char const> m_MappedArchive{};
+        /** Serializes reads through m_ArchiveReader if it doesn't support concurrent reads */
+        mutable std::mutex m_ArchiveReaderMutex;
+
+        /** Load groups in the archive, sorted by the hash of their name */
+        std::vector<LoadGroupInfo> m_LoadGroups;
+        /** Groups whose data was read into memory with LoadGroup() */
+        std::vector<LoadedGroup> m_LoadedGroups;
+        mutable std::mutex m_LoadedGroupsMutex;
+        /** Lets reads skip locking m_LoadedGroupsMutex while no group is loaded */
+        std::atomic<bool> m_HasLoadedGroups = false;
+
+        /** Threads that execute asynchronous reads. Created on the first asynchronous read. */
+        mutable std::unique_ptr<ThreadPool> m_IOThreadPool;
+        mutable std::mutex m_IOThreadPoolMutex;
+
+        /** Recently read files. Disabled until SetContentCacheBudget() is called. */
+        std::unique_ptr<ContentCache> m_ContentCache;
+
+        /** Read-path counters and latency histograms */
+        std::unique_ptr<ArchiveStatistics> m_Statistics;
+
+        /** Records file accesses while an access trace is being recorded */
+        std::unique_ptr<AccessTraceWriter> m_AccessTrace;
+        mutable std::mutex m_AccessTraceMutex;
+        /** Lets reads skip locking m_AccessTraceMutex while no trace is recorded */
+        std::atomic<bool> m_IsTracingAccesses = false;
+
+        /** If true, whole-file reads are checked against the file's checksum */
+        std::atomic<bool> m_VerifyChecksums = false;
 
-        /** Timestamp of the last time the archive was modified when we opened it */
-        time_t m_LastWriteTimestamp = 0;
+        /** Tracks intermediate files that are newer than the archive. Only used when reading outside of the archive. */
+        std::unique_ptr<IntermediateOverlay> m_IntermediateOverlay;
 
         /** The platform that Hako is currently being used on. Only used when reading outside of the archive. */
         Platform m_CurrentPlatform = Platform::Windows;
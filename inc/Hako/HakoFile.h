@@ -2,7 +2,16 @@
 
 #include "IFile.h"
 
+#include <memory>
+#include <mutex>
+#include <string>
+
+#if defined(__linux__) || defined(__APPLE__)
+// Use positional reads and writes on file descriptors, which don't share a file position between threads
+#define HAKO_POSIX_FILE_IO
+#else
 #include <fstream>
+#endif
 
 namespace hako
 {
@@ -15,14 +24,26 @@ namespace hako
         bool Open(std::string const& a_FilePath, FileOpenMode a_FileOpenMode);
 
         virtual bool Read(size_t a_NumBytes, size_t a_Offset, std::vector<char>& a_Buffer) override;
+        virtual bool Read(size_t a_NumBytes, size_t a_Offset, char* a_Buffer) override;
         virtual bool Write(size_t a_Offset, std::vector<char> const& a_Data) override;
         virtual size_t GetFileSize() override;
+        virtual bool SupportsConcurrentReads() const override;
+        virtual bool SupportsConcurrentWrites() const override;
+        virtual bool Prefetch(size_t a_NumBytes, size_t a_Offset) override;
+        virtual void Evict(size_t a_NumBytes, size_t a_Offset) override;
+        virtual bool CopyFrom(IFile& a_Source, size_t a_NumBytes, size_t a_SourceOffset, size_t a_Offset) override;
 
     private:
         void CloseFile();
 
     private:
+#if defined(HAKO_POSIX_FILE_IO)
+        int m_FileDescriptor = -1;
+        /** Serializes writes that use the file position instead of positional writes, i.e. sendfile() */
+        std::mutex m_FilePositionMutex;
+#else
         std::unique_ptr<std::fstream> m_FileHandle = nullptr;
+#endif
     };
 
     std::unique_ptr<IFile> HakoFileFactory(std::string const& a_FilePath, FileOpenMode a_FileOpenMode);
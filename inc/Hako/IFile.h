@@ -1,14 +1,22 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+#include "Span.h"
+
 namespace hako
 {
     enum class FileOpenMode : uint8_t
     {
         Read,
         WriteAppend,
-        WriteTruncate
+        WriteTruncate,
+        /** Read, but map the file into memory. Implementations that cannot map files may open the file for regular reading instead. */
+        ReadMapped,
+        /** Read, but bypass the OS page cache. Implementations that cannot bypass it may open the file for regular reading instead. */
+        ReadDirect
     };
 
     /**
@@ -29,6 +37,16 @@ namespace hako
          */
         virtual bool Read(size_t a_NumBytes, size_t a_Offset, std::vector<char>& a_Buffer) = 0;
 
+        /**
+         * Read from the opened file into a caller-provided buffer.
+         * The default implementation reads through a temporary vector, so implementations should override this if they can read into the buffer directly.
+         * @param a_NumBytes The number of bytes to read from the file
+         * @param a_Offset The offset from the start of the file at which the file's content should be read
+         * @param a_Buffer The buffer to output the read file content into. Should be at least a_NumBytes in size.
+         * @return True if the file was successfully read from
+         */
+        virtual bool Read(size_t a_NumBytes, size_t a_Offset, char* a_Buffer);
+
         /**
          * Write data to the opened file
          * @param a_Offset The offset from the start of the file at which the file's content should be written
@@ -42,5 +60,64 @@ namespace hako
          * @return The size of the file (in bytes)
          */
         virtual size_t GetFileSize() = 0;
+
+        /**
+         * Check if Read() may be called from multiple threads at the same time, for example because the implementation uses positional reads
+         * @return True if concurrent reads are safe
+         */
+        virtual bool SupportsConcurrentReads() const
+        {
+            return false;
+        }
+
+        /**
+         * Check if Write() may be called from multiple threads at the same time for ranges that don't overlap, for example because the implementation uses positional writes
+         * @return True if concurrent writes are safe
+         */
+        virtual bool SupportsConcurrentWrites() const
+        {
+            return false;
+        }
+
+        /**
+         * Hint that a range of the file will be read soon, so the implementation can start loading it into memory. Must not block until the range is loaded.
+         * @param a_NumBytes The number of bytes that will be read
+         * @param a_Offset The offset from the start of the file at which the range starts
+         * @return True if the hint was passed on, false if the implementation does not support prefetching
+         */
+        virtual bool Prefetch(size_t /*a_NumBytes*/, size_t /*a_Offset*/)
+        {
+            return false;
+        }
+
+        /**
+         * Hint that a range of the file won't be read for a while, so memory it occupies (e.g. in the OS page cache) may be released
+         * @param a_NumBytes The number of bytes in the range
+         * @param a_Offset The offset from the start of the file at which the range starts
+         */
+        virtual void Evict(size_t /*a_NumBytes*/, size_t /*a_Offset*/)
+        { }
+
+        /**
+         * Copy a range of another file into this file without passing it through a user-space buffer, e.g. with copy_file_range()
+         * @param a_Source The file to copy from
+         * @param a_NumBytes The number of bytes to copy
+         * @param a_SourceOffset The offset from the start of a_Source at which the range starts
+         * @param a_Offset The offset from the start of this file at which the range should be written
+         * @return True if the range was copied, false if the implementation can't copy from a_Source. Part of the range may have been written if false is returned.
+         */
+        virtual bool CopyFrom(IFile& /*a_Source*/, size_t /*a_NumBytes*/, size_t /*a_SourceOffset*/, size_t /*a_Offset*/)
+        {
+            return false;
+        }
+
+        /**
+         * Get the content of the opened file if it is mapped into memory
+         * @return A view of the entire file that stays valid until the file is closed, or an empty span if the file is not mapped into memory
+         */
+        virtual Span<char const> GetMappedContent() const
+        {
+            return {};
+        }
     };
 }
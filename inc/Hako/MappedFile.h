@@ -0,0 +1,49 @@
+#pragma once
+
+#include "IFile.h"
+
+#include <string>
+
+namespace hako
+{
+    /**
+     * Read-only file that is mapped into memory in its entirety
+     */
+    class MappedFile final : public IFile
+    {
+    public:
+        MappedFile() = default;
+        virtual ~MappedFile() override;
+
+        bool Open(std::string const& a_FilePath);
+
+        virtual bool Read(size_t a_NumBytes, size_t a_Offset, std::vector<char>& a_Buffer) override;
+        virtual bool Read(size_t a_NumBytes, size_t a_Offset, char* a_Buffer) override;
+        virtual bool Write(size_t a_Offset, std::vector<char> const& a_Data) override;
+        virtual size_t GetFileSize() override;
+        virtual bool SupportsConcurrentReads() const override;
+        virtual bool Prefetch(size_t a_NumBytes, size_t a_Offset) override;
+        virtual void Evict(size_t a_NumBytes, size_t a_Offset) override;
+        virtual Span<char const> GetMappedContent() const override;
+
+    private:
+        void CloseFile();
+
+#if !defined(_WIN32)
+        /**
+         * Get the page-aligned part of the mapping that covers a range of the file
+         * @return False if the range lies outside of the file
+         */
+        bool GetPageRange(size_t a_NumBytes, size_t a_Offset, void*& a_OutPageStart, size_t& a_OutPageRangeSize) const;
+#endif
+
+    private:
+        char const* m_Data = nullptr;
+        size_t m_Size = 0;
+
+#if defined(_WIN32)
+        void* m_FileHandle = nullptr;
+        void* m_MappingHandle = nullptr;
+#endif
+    };
+}
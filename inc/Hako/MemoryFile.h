@@ -0,0 +1,29 @@
+#pragma once
+
+#include "IFile.h"
+
+namespace hako
+{
+    /**
+     * Read-only file backed by memory owned by the caller, e.g. an archive that is embedded in the executable
+     */
+    class MemoryFile final : public IFile
+    {
+    public:
+        /**
+         * @param a_Data The file's content. Must stay valid for as long as the file is used.
+         */
+        explicit MemoryFile(Span<char const> a_Data);
+
+        virtual bool Read(size_t a_NumBytes, size_t a_Offset, std::vector<char>& a_Buffer) override;
+        virtual bool Read(size_t a_NumBytes, size_t a_Offset, char* a_Buffer) override;
+        virtual bool Write(size_t a_Offset, std::vector<char> const& a_Data) override;
+        virtual size_t GetFileSize() override;
+        virtual bool SupportsConcurrentReads() const override;
+        virtual bool Prefetch(size_t a_NumBytes, size_t a_Offset) override;
+        virtual Span<char const> GetMappedContent() const override;
+
+    private:
+        Span<char const> m_Data;
+    };
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace hako
+{
+    /** Alignment that buffers holding relocatable blobs need, and the maximum alignment of objects inside of a blob */
+    inline constexpr size_t RelocatableBlobAlignment = 16;
+
+    /**
+     * Header of a relocatable blob. Followed by a fixup table of ascending uint64_t payload offsets and the payload itself, which starts at m_PayloadOffset.
+     * Every fixup points at a 64-bit slot in the payload that holds the payload offset of the object it points to. Fixing up the blob replaces those offsets with pointers.
+     */
+    struct RelocatableBlobHeader
+    {
+        char m_Magic[4] = { 'H', 'K', 'R', 'B' };
+        uint32_t m_Version = 1;
+        uint32_t m_FixupCount = 0;
+        uint32_t m_Padding = 0;
+        /** Offset of the payload from the start of the blob. A multiple of RelocatableBlobAlignment. */
+        uint64_t m_PayloadOffset = 0;
+        /** Size of the payload in bytes */
+        uint64_t m_PayloadSize = 0;
+    };
+    static_assert(sizeof(RelocatableBlobHeader) == 32 && "RelocatableBlobHeader size changed");
+
+    /**
+     * Builds a relocatable blob: a payload of trivially copyable objects that can point at each other, which is loaded by reading it into memory and patching its pointers (see FixupRelocatableBlob()).
+     * Objects are addressed by their offset in the payload, as the payload may move while it grows. Pointers inside of the payload have to be 64 bits.
+     *
+     * Example serializer:
+     *     RelocatableBlobWriter writer;
+     *     size_t const mesh = writer.Allocate<Mesh>();
+     *     size_t const vertices = writer.WriteArray(sourceVertices.data(), sourceVertices.size());
+     *     writer.Access<Mesh>(mesh)->m_VertexCount = sourceVertices.size();
+     *     writer.SetPointer(mesh + offsetof(Mesh, m_Vertices), vertices);
+     *     return writer.Finish(a_OutBuffer);
+     */
+    class RelocatableBlobWriter final
+    {
+    public:
+        /**
+         * Add zero-initialized space to the payload
+         * @param a_NumBytes The number of bytes to add
+         * @param a_Alignment The alignment of the space. A power of two, no larger than RelocatableBlobAlignment.
+         * @return The payload offset of the space. The first allocation is at offset 0 and is returned as the blob's root.
+         */
+        size_t Allocate(size_t a_NumBytes, size_t a_Alignment);
+
+        /**
+         * Add zero-initialized space for one or more objects to the payload
+         * @param a_Count The number of objects
+         * @return The payload offset of the first object
+         */
+        template<typename T>
+        size_t Allocate(size_t a_Count = 1)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Relocatable blobs can only contain trivially copyable types");
+            return Allocate(sizeof(T) * a_Count, alignof(T));
+        }
+
+        /**
+         * Copy data into the payload
+         * @param a_Data The data to copy
+         * @param a_NumBytes The number of bytes to copy
+         * @param a_Alignment The alignment of the data in the payload
+         * @return The payload offset of the copied data
+         */
+        size_t Write(void const* a_Data, size_t a_NumBytes, size_t a_Alignment);
+
+        /**
+         * Copy an array of objects into the payload
+         * @param a_Values The objects to copy
+         * @param a_Count The number of objects
+         * @return The payload offset of the first object
+         */
+        template<typename T>
+        size_t WriteArray(T const* a_Values, size_t a_Count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Relocatable blobs can only contain trivially copyable types");
+            return Write(a_Values, sizeof(T) * a_Count, alignof(T));
+        }
+
+        /**
+         * Access an object in the payload, e.g. to fill in its fields
+         * @param a_Offset The payload offset of the object
+         * @return A pointer to the object, which is invalidated by the next allocation
+         */
+        template<typename T>
+        T* Access(size_t a_Offset)
+        {
+            return reinterpret_cast<T*>(m_Payload.data() + a_Offset);
+        }
+
+        /**
+         * Make a pointer in the payload point at another object in the payload. Null pointers don't need to be set, as they are left at zero.
+         * @param a_PointerOffset The payload offset of the pointer. Must be 8-byte aligned.
+         * @param a_TargetOffset The payload offset of the object to point at. May be the end of the payload, for empty arrays.
+         */
+        void SetPointer(size_t a_PointerOffset, size_t a_TargetOffset);
+
+        /**
+         * @return The current size of the payload in bytes
+         */
+        size_t GetPayloadSize() const;
+
+        /**
+         * Write the finished blob to a buffer
+         * @param a_OutBuffer The buffer to write the blob into. Its previous content is replaced.
+         * @return The size of the blob in bytes
+         */
+        size_t Finish(std::vector<char>& a_OutBuffer) const;
+
+    private:
+        std::vector<char> m_Payload;
+        std::vector<uint64_t> m_Fixups;
+    };
+
+    /**
+     * Patch the pointers in a relocatable blob, so the payload's objects can be used straight from the buffer. Validates the blob's header and fixup table before patching.
+     * @note A blob can only be fixed up once, and can't be moved after it was fixed up.
+     * @param a_Blob The blob, aligned to RelocatableBlobAlignment
+     * @param a_BlobSize The size of the blob in bytes
+     * @return A pointer to the payload's root object (the first allocation), or a nullptr if the blob is invalid
+     */
+    void* FixupRelocatableBlob(char* a_Blob, size_t a_BlobSize);
+}
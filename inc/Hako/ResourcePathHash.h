@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace hako
+{
+    struct ResourcePathHash
+    {
+        static ResourcePathHash FromString(char const* a_Hash);
+        [[nodiscard]] std::string ToString() const;
+        /**
+         * @param a_OutBuffer Buffer is expected to be (at least) MaxResourcePathHashLength in length.
+         */
+        void ToString(char* a_OutBuffer) const;
+
+        constexpr bool operator==(ResourcePathHash const& a_Rhs) const
+        {
+            return hash64[0] == a_Rhs.hash64[0] && hash64[1] == a_Rhs.hash64[1];
+        }
+
+        constexpr bool operator!=(ResourcePathHash const& a_Rhs) const
+        {
+            return !(*this == a_Rhs);
+        }
+
+        bool operator<(ResourcePathHash const& a_Rhs) const;
+        bool operator<=(ResourcePathHash const& a_Rhs) const;
+        bool operator>(ResourcePathHash const& a_Rhs) const;
+        bool operator>=(ResourcePathHash const& a_Rhs) const;
+
+        uint64_t hash64[2]{};
+    };
+
+    namespace detail
+    {
+        // -----------------------------------------------------------------------------
+        // constexpr port of MurmurHash3_x64_128 from https://github.com/aappleby/smhasher/blob/master/src/MurmurHash3.cpp
+        // MurmurHash3 was written by Austin Appleby, and is placed in the public domain.
+        // Blocks are read as little-endian, which matches the original on the platforms Hako targets.
+
+        inline constexpr uint32_t ResourcePathHashSeed = 0x48'41'4B'4F;
+
+        constexpr uint64_t RotateLeft64(uint64_t a_Value, int a_Shift)
+        {
+            return (a_Value << a_Shift) | (a_Value >> (64 - a_Shift));
+        }
+
+        constexpr uint64_t FinalizationMix64(uint64_t a_Value)
+        {
+            a_Value ^= a_Value >> 33;
+            a_Value *= 0xff51afd7ed558ccdULL;
+            a_Value ^= a_Value >> 33;
+            a_Value *= 0xc4ceb9fe1a85ec53ULL;
+            a_Value ^= a_Value >> 33;
+
+            return a_Value;
+        }
+
+        constexpr uint64_t ReadBlock64(char const* a_Data, size_t a_ByteCount = 8)
+        {
+            uint64_t block = 0;
+            for (size_t i = 0; i < a_ByteCount; ++i)
+            {
+                block |= static_cast<uint64_t>(static_cast<uint8_t>(a_Data[i])) << (i * 8);
+            }
+
+            return block;
+        }
+
+        constexpr ResourcePathHash MurmurHash3_x64_128(char const* a_Data, size_t a_Length, uint32_t a_Seed)
+        {
+            constexpr uint64_t c1 = 0x87c37b91114253d5ULL;
+            constexpr uint64_t c2 = 0x4cf5ad432745937fULL;
+
+            uint64_t h1 = a_Seed;
+            uint64_t h2 = a_Seed;
+
+            size_t const blockCount = a_Length / 16;
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                uint64_t k1 = ReadBlock64(a_Data + i * 16);
+                uint64_t k2 = ReadBlock64(a_Data + i * 16 + 8);
+
+                k1 *= c1; k1 = RotateLeft64(k1, 31); k1 *= c2; h1 ^= k1;
+                h1 = RotateLeft64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+                k2 *= c2; k2 = RotateLeft64(k2, 33); k2 *= c1; h2 ^= k2;
+                h2 = RotateLeft64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+            }
+
+            char const* const tail = a_Data + blockCount * 16;
+            size_t const tailLength = a_Length & 15;
+
+            if (tailLength > 8)
+            {
+                uint64_t k2 = ReadBlock64(tail + 8, tailLength - 8);
+                k2 *= c2; k2 = RotateLeft64(k2, 33); k2 *= c1; h2 ^= k2;
+            }
+
+            if (tailLength > 0)
+            {
+                uint64_t k1 = ReadBlock64(tail, tailLength < 8 ? tailLength : 8);
+                k1 *= c1; k1 = RotateLeft64(k1, 31); k1 *= c2; h1 ^= k1;
+            }
+
+            h1 ^= a_Length;
+            h2 ^= a_Length;
+
+            h1 += h2;
+            h2 += h1;
+
+            h1 = FinalizationMix64(h1);
+            h2 = FinalizationMix64(h2);
+
+            h1 += h2;
+            h2 += h1;
+
+            return ResourcePathHash{ { h1, h2 } };
+        }
+
+        constexpr size_t StringLength(char const* a_String)
+        {
+            size_t length = 0;
+            while (a_String[length] != 0)
+            {
+                ++length;
+            }
+
+            return length;
+        }
+
+        template<uint64_t Hash0, uint64_t Hash1>
+        struct ConstantResourcePathHash
+        {
+            static constexpr ResourcePathHash Value{ { Hash0, Hash1 } };
+        };
+    }
+
+    /**
+     * Get a hash for a resource path or name. Matches GetResourcePathHash, but can be evaluated at compile time.
+     * @param a_Path The path or name of the resource
+     * @param a_Length The length of a_Path, excluding the null-terminator
+     * @return The hash for a_Path
+     */
+    constexpr ResourcePathHash HashResourcePath(char const* a_Path, size_t a_Length)
+    {
+        return detail::MurmurHash3_x64_128(a_Path, a_Length, detail::ResourcePathHashSeed);
+    }
+
+    /**
+     * Get a hash for a null-terminated resource path or name. Matches GetResourcePathHash, but can be evaluated at compile time.
+     * @param a_Path The path or name of the resource
+     * @return The hash for a_Path
+     */
+    constexpr ResourcePathHash HashResourcePath(char const* a_Path)
+    {
+        return HashResourcePath(a_Path, detail::StringLength(a_Path));
+    }
+
+    namespace literals
+    {
+        /**
+         * Hash a resource path, e.g. "Textures/Rock.png"_hako
+         */
+        constexpr ResourcePathHash operator""_hako(char const* a_Path, size_t a_Length)
+        {
+            return HashResourcePath(a_Path, a_Length);
+        }
+    }
+}
+
+template<>
+struct std::hash<hako::ResourcePathHash>
+{
+    size_t operator()(hako::ResourcePathHash const& a_Hash) const noexcept
+    {
+        // The path hash is already well distributed
+        return static_cast<size_t>(a_Hash.hash64[0] ^ a_Hash.hash64[1]);
+    }
+};
+
+/**
+ * Get the hash for a resource path literal. The hash is always computed at compile time.
+ */
+#define HAKO_RESOURCE(a_Path) (::hako::detail::ConstantResourcePathHash<::hako::HashResourcePath(a_Path).hash64[0], ::hako::HashResourcePath(a_Path).hash64[1]>::Value)
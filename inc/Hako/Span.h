@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace hako
+{
+    /**
+     * Non-owning view of a contiguous range of elements
+     * @note Mirrors the subset of std::span that Hako needs, as Hako targets C++17
+     */
+    template<typename T>
+    class Span
+    {
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using iterator = T*;
+
+    public:
+        constexpr Span() = default;
+        constexpr Span(T* a_Data, size_t a_Size)
+            : m_Data(a_Data)
+            , m_Size(a_Size)
+        { }
+
+        template<typename Container, typename = std::enable_if_t<std::is_convertible_v<decltype(std::data(std::declval<Container&>())), T*>>>
+        constexpr Span(Container& a_Container)
+            : m_Data(std::data(a_Container))
+            , m_Size(std::size(a_Container))
+        { }
+
+        template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+        constexpr Span(Span<U> const& a_Other)
+            : m_Data(a_Other.data())
+            , m_Size(a_Other.size())
+        { }
+
+        constexpr T* data() const { return m_Data; }
+        constexpr size_t size() const { return m_Size; }
+        constexpr bool empty() const { return m_Size == 0; }
+
+        constexpr T* begin() const { return m_Data; }
+        constexpr T* end() const { return m_Data + m_Size; }
+
+        constexpr T& operator[](size_t a_Index) const { return m_Data[a_Index]; }
+
+        constexpr Span subspan(size_t a_Offset, size_t a_Count) const
+        {
+            return { m_Data + a_Offset, a_Count };
+        }
+
+    private:
+        T* m_Data = nullptr;
+        size_t m_Size = 0;
+    };
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "Hako.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace hako
+{
+    /** Identifies a request made to a StreamingScheduler. 0 is never a valid id. */
+    using StreamingRequestId = uint64_t;
+
+    enum class StreamingStatus : uint8_t
+    {
+        /** The file was read */
+        Completed,
+        /** The file could not be read */
+        Failed,
+        /** The request was cancelled before it was dispatched */
+        Cancelled,
+    };
+
+    struct StreamingRequestResult
+    {
+        StreamingRequestId m_RequestId = 0;
+        ResourcePathHash m_ResourcePathHash{};
+        StreamingStatus m_Status = StreamingStatus::Failed;
+        /** True if the request finished after its deadline */
+        bool m_MissedDeadline = false;
+    };
+
+    struct StreamingSchedulerSettings
+    {
+        /** Number of threads that read files. At least one thread is always started. */
+        size_t m_ThreadCount = 2;
+        /** Maximum number of bytes of file content that may be in flight (read, but not yet handled by a callback) at once. 0 removes the cap. A file larger than the cap is dispatched once nothing else is in flight. */
+        size_t m_MaxInFlightBytes = 64 * 1024 * 1024;
+        /** Maximum number of bytes to dispatch per second. 0 removes the cap. */
+        size_t m_MaxBytesPerSecond = 0;
+    };
+
+    /**
+     * Schedules reads from an archive by priority and deadline, e.g. to stream assets near the camera before bulk background loads.
+     * Queued requests are dispatched by priority (highest first), then by deadline (earliest first). Requests that tie are dispatched in the order in which they are stored in the archive, sweeping through the archive like an elevator to reduce seeking.
+     * Requests can be reprioritized or cancelled until they are dispatched. All member functions may be called from multiple threads at once.
+     */
+    class StreamingScheduler final
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * Called on one of the scheduler's threads once a request finishes, or on the cancelling thread if a request is cancelled
+         * @param a_Result The request that finished
+         * @param a_Data The file's content if the request completed. The callback may move out of it.
+         */
+        using Callback = std::function<void(StreamingRequestResult const& a_Result, std::vector<char>& a_Data)>;
+
+    public:
+        /**
+         * @param a_Archive The archive to read from. Must stay open until the scheduler is destroyed.
+         * @param a_Settings Settings for the number of threads and the in-flight and bandwidth caps
+         */
+        explicit StreamingScheduler(Archive const& a_Archive, StreamingSchedulerSettings const& a_Settings = {});
+        /**
+         * Cancels all queued requests and waits for requests that are in flight to finish
+         */
+        ~StreamingScheduler();
+
+        StreamingScheduler(StreamingScheduler&) = delete;
+        StreamingScheduler(StreamingScheduler const&) = delete;
+        StreamingScheduler& operator=(StreamingScheduler const&) = delete;
+        StreamingScheduler(StreamingScheduler&&) = delete;
+        StreamingScheduler& operator=(StreamingScheduler&&) = delete;
+
+        /**
+         * Queue a file to be read
+         * @param a_ResourcePathHash The hash of the file to read
+         * @param a_Priority The request's priority. Requests with a higher priority are dispatched first.
+         * @param a_Deadline The time by which the file is needed. Requests with the same priority are dispatched in order of their deadlines.
+         * @param a_Callback The function to call once the request finishes
+         * @return The request's id, or 0 if the archive does not contain the file
+         */
+        StreamingRequestId Request(ResourcePathHash const& a_ResourcePathHash, int32_t a_Priority, Clock::time_point a_Deadline, Callback a_Callback);
+
+        /**
+         * Queue a file to be read without a deadline
+         * @param a_ResourcePathHash The hash of the file to read
+         * @param a_Priority The request's priority. Requests with a higher priority are dispatched first.
+         * @param a_Callback The function to call once the request finishes
+         * @return The request's id, or 0 if the archive does not contain the file
+         */
+        StreamingRequestId Request(ResourcePathHash const& a_ResourcePathHash, int32_t a_Priority, Callback a_Callback);
+
+        /**
+         * Change the priority of a queued request
+         * @param a_RequestId The request to change
+         * @param a_Priority The request's new priority
+         * @return True if the request was still queued
+         */
+        bool Reprioritize(StreamingRequestId a_RequestId, int32_t a_Priority);
+
+        /**
+         * Change the deadline of a queued request
+         * @param a_RequestId The request to change
+         * @param a_Deadline The request's new deadline
+         * @return True if the request was still queued
+         */
+        bool SetDeadline(StreamingRequestId a_RequestId, Clock::time_point a_Deadline);
+
+        /**
+         * Cancel a queued request. Its callback is called with StreamingStatus::Cancelled before this function returns.
+         * @param a_RequestId The request to cancel
+         * @return True if the request was still queued. Requests that are in flight can't be cancelled.
+         */
+        bool Cancel(StreamingRequestId a_RequestId);
+
+        /**
+         * Cancel all queued requests
+         */
+        void CancelAll();
+
+        /**
+         * Block until no requests are queued or in flight
+         */
+        void WaitUntilIdle();
+
+        /**
+         * @return The number of requests that are waiting to be dispatched
+         */
+        size_t GetQueuedRequestCount() const;
+
+        /**
+         * @return The number of bytes of file content that are currently in flight
+         */
+        size_t GetInFlightBytes() const;
+
+    private:
+        struct QueuedRequest
+        {
+            int32_t m_Priority = 0;
+            Clock::time_point m_Deadline = Clock::time_point::max();
+            size_t m_ArchiveOffset = 0;
+            StreamingRequestId m_RequestId = 0;
+
+            ResourcePathHash m_ResourcePathHash{};
+            size_t m_Size = 0;
+            Callback m_Callback = nullptr;
+
+            /** Dispatch order: highest priority, then earliest deadline, then lowest archive offset */
+            bool operator<(QueuedRequest const& a_Rhs) const;
+        };
+
+        using Queue = std::set<QueuedRequest>;
+
+        void WorkerLoop();
+
+        /**
+         * Pick the request to dispatch next. Expects m_Mutex to be locked and the queue not to be empty.
+         */
+        Queue::iterator GetNextRequest() const;
+
+        /**
+         * Call the callbacks of requests that were cancelled, with m_Mutex unlocked
+         */
+        static void NotifyCancelled(std::vector<QueuedRequest>& a_CancelledRequests);
+
+    private:
+        Archive const& m_Archive;
+        StreamingSchedulerSettings const m_Settings;
+
+        std::vector<std::thread> m_Threads;
+
+        mutable std::mutex m_Mutex;
+        /** Signalled when a request is queued or finishes, or the scheduler shuts down */
+        std::condition_variable m_StateChanged;
+
+        Queue m_Queue;
+        std::unordered_map<StreamingRequestId, Queue::iterator> m_QueuedRequests;
+        StreamingRequestId m_NextRequestId = 1;
+
+        /** Archive offset of the last dispatched request, where the elevator sweep continues */
+        size_t m_LastDispatchedOffset = 0;
+        size_t m_InFlightBytes = 0;
+        size_t m_InFlightRequestCount = 0;
+        /** Earliest time at which the next request may be dispatched without exceeding the bandwidth cap */
+        Clock::time_point m_NextDispatchTime{};
+
+        bool m_ShuttingDown = false;
+    };
+}
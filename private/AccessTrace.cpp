@@ -0,0 +1,106 @@
+#include "AccessTrace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+using namespace hako;
+
+namespace
+{
+    /** Number of accesses to buffer before they are written to the trace file */
+    constexpr size_t MaxBufferedEntryCount = 4096;
+}
+
+AccessTraceWriter::AccessTraceWriter(std::unique_ptr<IFile> a_File)
+    : m_File(std::move(a_File))
+    , m_StartTime(std::chrono::steady_clock::now())
+{
+    AccessTraceHeader const header{};
+
+    std::vector<char> buffer(sizeof(AccessTraceHeader));
+    memcpy(buffer.data(), &header, sizeof(AccessTraceHeader));
+    m_File->Write(0, buffer);
+    m_BytesWritten = sizeof(AccessTraceHeader);
+
+    m_BufferedEntries.reserve(MaxBufferedEntryCount);
+}
+
+AccessTraceWriter::~AccessTraceWriter()
+{
+    Flush();
+}
+
+void AccessTraceWriter::Record(ResourcePathHash const& a_ResourcePathHash)
+{
+    auto const timeSinceStart = std::chrono::steady_clock::now() - m_StartTime;
+    m_BufferedEntries.push_back({ a_ResourcePathHash, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(timeSinceStart).count()) });
+
+    if (m_BufferedEntries.size() >= MaxBufferedEntryCount)
+    {
+        Flush();
+    }
+}
+
+bool AccessTraceWriter::Flush()
+{
+    if (m_BufferedEntries.empty())
+    {
+        return true;
+    }
+
+    size_t const numBytes = m_BufferedEntries.size() * sizeof(AccessTraceEntry);
+    std::vector<char> buffer(numBytes);
+    memcpy(buffer.data(), m_BufferedEntries.data(), numBytes);
+    m_BufferedEntries.clear();
+
+    bool const success = m_File->Write(m_BytesWritten, buffer);
+    m_BytesWritten += numBytes;
+
+    return success;
+}
+
+bool hako::ReadAccessTrace(IFile& a_File, std::vector<ResourcePathHash>& a_OutFirstAccessOrder)
+{
+    a_OutFirstAccessOrder.clear();
+
+    size_t const fileSize = a_File.GetFileSize();
+    if (fileSize < sizeof(AccessTraceHeader))
+    {
+        return false;
+    }
+
+    AccessTraceHeader header{};
+    AccessTraceHeader const expectedHeader{};
+    if (!a_File.Read(sizeof(AccessTraceHeader), 0, reinterpret_cast<char*>(&header))
+        || memcmp(header.m_Magic, expectedHeader.m_Magic, sizeof(header.m_Magic)) != 0
+        || header.m_Version != expectedHeader.m_Version)
+    {
+        return false;
+    }
+
+    // Ignore a partially written entry at the end of the trace
+    std::vector<AccessTraceEntry> entries((fileSize - sizeof(AccessTraceHeader)) / sizeof(AccessTraceEntry));
+    if (!entries.empty() && !a_File.Read(entries.size() * sizeof(AccessTraceEntry), sizeof(AccessTraceHeader), reinterpret_cast<char*>(entries.data())))
+    {
+        return false;
+    }
+
+    // Entries are recorded in order, but traces could have been merged or edited
+    std::stable_sort(entries.begin(), entries.end(), [](AccessTraceEntry const& a_Lhs, AccessTraceEntry const& a_Rhs)
+        {
+            return a_Lhs.m_TimestampNanoseconds < a_Rhs.m_TimestampNanoseconds;
+        }
+    );
+
+    std::unordered_set<ResourcePathHash> accessedFiles{};
+    for (AccessTraceEntry const& entry : entries)
+    {
+        if (accessedFiles.insert(entry.m_ResourcePathHash).second)
+        {
+            a_OutFirstAccessOrder.push_back(entry.m_ResourcePathHash);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "IFile.h"
+#include "ResourcePathHash.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace hako
+{
+    /**
+     * Header of an access trace file, which is followed by AccessTraceEntry records in the order in which files were accessed
+     */
+    struct AccessTraceHeader
+    {
+        char m_Magic[4] = { 'H', 'K', 'T', 'R' };
+        uint32_t m_Version = 1;
+    };
+
+    struct AccessTraceEntry
+    {
+        ResourcePathHash m_ResourcePathHash{};
+        /** Time since the trace was started */
+        uint64_t m_TimestampNanoseconds = 0;
+    };
+    static_assert(sizeof(AccessTraceEntry) == 24 && "AccessTraceEntry size changed");
+
+    /**
+     * Records file accesses to an access trace file. Not thread-safe.
+     */
+    class AccessTraceWriter final
+    {
+    public:
+        /**
+         * @param a_File The file to write the trace to. Expected to be opened for writing and empty.
+         */
+        explicit AccessTraceWriter(std::unique_ptr<IFile> a_File);
+        /**
+         * Writes any accesses that are still buffered
+         */
+        ~AccessTraceWriter();
+
+        AccessTraceWriter(AccessTraceWriter&) = delete;
+        AccessTraceWriter(AccessTraceWriter const&) = delete;
+        AccessTraceWriter& operator=(AccessTraceWriter const&) = delete;
+        AccessTraceWriter(AccessTraceWriter&&) = delete;
+        AccessTraceWriter& operator=(AccessTraceWriter&&) = delete;
+
+        /**
+         * Record an access to a file
+         * @param a_ResourcePathHash The hash of the file that was accessed
+         */
+        void Record(ResourcePathHash const& a_ResourcePathHash);
+
+        /**
+         * Write all buffered accesses to the trace file
+         * @return True if writing was successful
+         */
+        bool Flush();
+
+    private:
+        std::unique_ptr<IFile> m_File = nullptr;
+        size_t m_BytesWritten = 0;
+
+        std::chrono::steady_clock::time_point m_StartTime{};
+        std::vector<AccessTraceEntry> m_BufferedEntries{};
+    };
+
+    /**
+     * Read an access trace file
+     * @param a_File The trace file, opened for reading
+     * @param a_OutFirstAccessOrder The files in the trace, in the order in which they were first accessed (out)
+     * @return True if the file is a valid access trace
+     */
+    bool ReadAccessTrace(IFile& a_File, std::vector<ResourcePathHash>& a_OutFirstAccessOrder);
+}
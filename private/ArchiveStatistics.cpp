@@ -0,0 +1,84 @@
+#include "ArchiveStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace hako;
+
+uint64_t LatencyHistogram::GetPercentile(double a_Percentile) const
+{
+    if (m_Count == 0)
+    {
+        return 0;
+    }
+
+    // Rank of the operation that marks the percentile, counting from 1
+    double const clampedPercentile = std::fmin(std::fmax(a_Percentile, 0.0), 100.0);
+    uint64_t const rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clampedPercentile / 100.0 * static_cast<double>(m_Count))));
+
+    uint64_t count = 0;
+    for (size_t bucket = 0; bucket < BucketCount; ++bucket)
+    {
+        count += m_Buckets[bucket];
+        if (count >= rank)
+        {
+            return (uint64_t(2) << bucket) - 1;
+        }
+    }
+
+    return (uint64_t(2) << (BucketCount - 1)) - 1;
+}
+
+ArchiveStats ArchiveStatistics::GetStats() const
+{
+    ArchiveStats stats;
+
+#ifndef HAKO_NO_STATS
+    m_Lookups.m_Latency.Snapshot(stats.m_LookupLatency);
+    stats.m_LookupCount = m_Lookups.m_Count.load(std::memory_order_relaxed);
+    stats.m_LookupMissCount = m_Lookups.m_MissCount.load(std::memory_order_relaxed);
+
+    m_Reads.m_Latency.Snapshot(stats.m_ReadLatency);
+    stats.m_ReadCount = m_Reads.m_FileCount.load(std::memory_order_relaxed);
+    stats.m_BytesRead = m_Reads.m_ByteCount.load(std::memory_order_relaxed);
+
+    stats.m_OverlayHitCount = m_OverlayHitCount.load(std::memory_order_relaxed);
+#endif
+
+    return stats;
+}
+
+void ArchiveStatistics::Reset()
+{
+    m_Lookups.m_Count.store(0, std::memory_order_relaxed);
+    m_Lookups.m_MissCount.store(0, std::memory_order_relaxed);
+    m_Lookups.m_Latency.Reset();
+
+    m_Reads.m_FileCount.store(0, std::memory_order_relaxed);
+    m_Reads.m_ByteCount.store(0, std::memory_order_relaxed);
+    m_Reads.m_Latency.Reset();
+
+    m_OverlayHitCount.store(0, std::memory_order_relaxed);
+}
+
+void ArchiveStatistics::AtomicLatencyHistogram::Snapshot(LatencyHistogram& a_OutHistogram) const
+{
+    a_OutHistogram.m_Count = 0;
+    for (size_t bucket = 0; bucket < LatencyHistogram::BucketCount; ++bucket)
+    {
+        a_OutHistogram.m_Buckets[bucket] = m_Buckets[bucket].load(std::memory_order_relaxed);
+        a_OutHistogram.m_Count += a_OutHistogram.m_Buckets[bucket];
+    }
+
+    a_OutHistogram.m_TotalNanoseconds = m_TotalNanoseconds.load(std::memory_order_relaxed);
+}
+
+void ArchiveStatistics::AtomicLatencyHistogram::Reset()
+{
+    for (std::atomic<uint64_t>& bucket : m_Buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+
+    m_TotalNanoseconds.store(0, std::memory_order_relaxed);
+}
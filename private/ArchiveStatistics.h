@@ -0,0 +1,188 @@
+#pragma once
+
+#include "Hako.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace hako
+{
+    /**
+     * Thread-safe read-path counters and latency histograms of an archive (see Archive::GetStats()).
+     * Counters are relaxed atomics, so recording never blocks. When HAKO_NO_STATS is defined, all recording functions are empty and compile away.
+     */
+    class ArchiveStatistics final
+    {
+    public:
+        /** Only one in this many lookups is timed, as reading the clock can take longer than the lookup itself */
+        static constexpr uint32_t LookupSampleInterval = 16;
+
+        /**
+         * Measures the time since it was created. Doesn't read the clock when it isn't running or HAKO_NO_STATS is defined.
+         */
+        class Timer
+        {
+        public:
+#ifndef HAKO_NO_STATS
+            explicit Timer(bool a_IsRunning = true)
+                : m_Start(a_IsRunning ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{})
+                , m_IsRunning(a_IsRunning)
+            { }
+
+            bool IsRunning() const
+            {
+                return m_IsRunning;
+            }
+
+            uint64_t GetElapsedNanoseconds() const
+            {
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start).count());
+            }
+
+        private:
+            std::chrono::steady_clock::time_point m_Start;
+            bool m_IsRunning = false;
+#else
+            explicit Timer(bool = true)
+            { }
+
+            bool IsRunning() const
+            {
+                return false;
+            }
+
+            uint64_t GetElapsedNanoseconds() const
+            {
+                return 0;
+            }
+#endif
+        };
+
+        /**
+         * @return A timer for a lookup, which only runs for one in every LookupSampleInterval lookups on the calling thread
+         */
+        static Timer StartLookupTimer()
+        {
+#ifndef HAKO_NO_STATS
+            thread_local uint32_t lookupIndex = 0;
+            return Timer(++lookupIndex % LookupSampleInterval == 0);
+#else
+            return Timer();
+#endif
+        }
+
+    public:
+        /**
+         * Record a lookup of a file in the table of contents
+         * @param a_Found True if the file was found
+         * @param a_Timer Timer that was started with StartLookupTimer() when the lookup started. Its latency is only recorded if it is running.
+         */
+        void RecordLookup(bool a_Found, Timer const& a_Timer)
+        {
+#ifndef HAKO_NO_STATS
+            m_Lookups.m_Count.fetch_add(1, std::memory_order_relaxed);
+            if (a_Timer.IsRunning())
+            {
+                m_Lookups.m_Latency.Record(a_Timer.GetElapsedNanoseconds());
+            }
+
+            if (!a_Found)
+            {
+                m_Lookups.m_MissCount.fetch_add(1, std::memory_order_relaxed);
+            }
+#else
+            (void)a_Found;
+            (void)a_Timer;
+#endif
+        }
+
+        /**
+         * Record a read of file content from the archive
+         * @param a_NumFiles The number of files (or file ranges) that were read
+         * @param a_NumBytes The number of bytes of file content that were read
+         * @param a_Timer Timer that was started when the read started
+         */
+        void RecordRead(size_t a_NumFiles, size_t a_NumBytes, Timer const& a_Timer)
+        {
+#ifndef HAKO_NO_STATS
+            m_Reads.m_Latency.Record(a_Timer.GetElapsedNanoseconds());
+            m_Reads.m_FileCount.fetch_add(a_NumFiles, std::memory_order_relaxed);
+            m_Reads.m_ByteCount.fetch_add(a_NumBytes, std::memory_order_relaxed);
+#else
+            (void)a_NumFiles;
+            (void)a_NumBytes;
+            (void)a_Timer;
+#endif
+        }
+
+        /**
+         * Record that a newer version of a file was found outside of the archive
+         */
+        void RecordOverlayHit()
+        {
+#ifndef HAKO_NO_STATS
+            m_OverlayHitCount.fetch_add(1, std::memory_order_relaxed);
+#endif
+        }
+
+        /**
+         * @return A snapshot of all counters. Counters that are updated while the snapshot is taken may or may not be included.
+         */
+        ArchiveStats GetStats() const;
+
+        /**
+         * Set all counters back to zero
+         */
+        void Reset();
+
+    private:
+        struct AtomicLatencyHistogram
+        {
+            void Record(uint64_t a_Nanoseconds)
+            {
+                m_Buckets[GetBucket(a_Nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+                m_TotalNanoseconds.fetch_add(a_Nanoseconds, std::memory_order_relaxed);
+            }
+
+            /**
+             * @return The index of the power-of-two bucket that a latency falls into
+             */
+            static size_t GetBucket(uint64_t a_Nanoseconds)
+            {
+                size_t bucket = 0;
+                while (a_Nanoseconds > 1 && bucket + 1 < LatencyHistogram::BucketCount)
+                {
+                    a_Nanoseconds >>= 1;
+                    ++bucket;
+                }
+
+                return bucket;
+            }
+
+            void Snapshot(LatencyHistogram& a_OutHistogram) const;
+            void Reset();
+
+            std::atomic<uint64_t> m_Buckets[LatencyHistogram::BucketCount]{};
+            std::atomic<uint64_t> m_TotalNanoseconds = 0;
+        };
+
+        // Lookups and reads are usually recorded by different code paths, so keep them on separate cache lines
+        struct alignas(64) LookupCounters
+        {
+            std::atomic<uint64_t> m_Count = 0;
+            std::atomic<uint64_t> m_MissCount = 0;
+            AtomicLatencyHistogram m_Latency;
+        };
+
+        struct alignas(64) ReadCounters
+        {
+            std::atomic<uint64_t> m_FileCount = 0;
+            std::atomic<uint64_t> m_ByteCount = 0;
+            AtomicLatencyHistogram m_Latency;
+        };
+
+        LookupCounters m_Lookups;
+        ReadCounters m_Reads;
+        alignas(64) std::atomic<uint64_t> m_OverlayHitCount = 0;
+    };
+}
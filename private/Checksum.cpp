@@ -0,0 +1,136 @@
+#include "Checksum.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <nmmintrin.h>
+#define HAKO_CRC32C_SSE42
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define HAKO_CRC32C_ARM
+#endif
+
+using namespace hako;
+
+namespace
+{
+    /** Reversed CRC32C polynomial */
+    constexpr uint32_t Crc32cPolynomial = 0x82F63B78;
+
+    constexpr std::array<uint32_t, 256> CreateCrc32cTable()
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ ((crc & 1) ? Crc32cPolynomial : 0);
+            }
+
+            table[i] = crc;
+        }
+
+        return table;
+    }
+
+    constexpr std::array<uint32_t, 256> Crc32cTable = CreateCrc32cTable();
+
+    uint32_t ComputeCrc32cSoftware(unsigned char const* a_Data, size_t a_NumBytes, uint32_t a_Crc)
+    {
+        for (size_t i = 0; i < a_NumBytes; ++i)
+        {
+            a_Crc = Crc32cTable[(a_Crc ^ a_Data[i]) & 0xFF] ^ (a_Crc >> 8);
+        }
+
+        return a_Crc;
+    }
+
+#if defined(HAKO_CRC32C_SSE42)
+#if !defined(_MSC_VER)
+    __attribute__((target("sse4.2")))
+#endif
+    uint32_t ComputeCrc32cHardware(unsigned char const* a_Data, size_t a_NumBytes, uint32_t a_Crc)
+    {
+        uint64_t crc = a_Crc;
+        while (a_NumBytes >= sizeof(uint64_t))
+        {
+            uint64_t block = 0;
+            memcpy(&block, a_Data, sizeof(uint64_t));
+            crc = _mm_crc32_u64(crc, block);
+
+            a_Data += sizeof(uint64_t);
+            a_NumBytes -= sizeof(uint64_t);
+        }
+
+        uint32_t crc32 = static_cast<uint32_t>(crc);
+        while (a_NumBytes > 0)
+        {
+            crc32 = _mm_crc32_u8(crc32, *a_Data);
+            ++a_Data;
+            --a_NumBytes;
+        }
+
+        return crc32;
+    }
+
+    bool HasHardwareCrc32c()
+    {
+#if defined(_MSC_VER)
+        int cpuInfo[4]{};
+        __cpuid(cpuInfo, 1);
+        return (cpuInfo[2] & (1 << 20)) != 0;
+#else
+        return __builtin_cpu_supports("sse4.2");
+#endif
+    }
+#elif defined(HAKO_CRC32C_ARM)
+    uint32_t ComputeCrc32cHardware(unsigned char const* a_Data, size_t a_NumBytes, uint32_t a_Crc)
+    {
+        while (a_NumBytes >= sizeof(uint64_t))
+        {
+            uint64_t block = 0;
+            memcpy(&block, a_Data, sizeof(uint64_t));
+            a_Crc = __crc32cd(a_Crc, block);
+
+            a_Data += sizeof(uint64_t);
+            a_NumBytes -= sizeof(uint64_t);
+        }
+
+        while (a_NumBytes > 0)
+        {
+            a_Crc = __crc32cb(a_Crc, *a_Data);
+            ++a_Data;
+            --a_NumBytes;
+        }
+
+        return a_Crc;
+    }
+
+    bool HasHardwareCrc32c()
+    {
+        // Only compiled in when the target is guaranteed to support the CRC extension
+        return true;
+    }
+#endif
+}
+
+uint32_t hako::ComputeCrc32c(char const* a_Data, size_t a_NumBytes, uint32_t a_Checksum)
+{
+    unsigned char const* const data = reinterpret_cast<unsigned char const*>(a_Data);
+    uint32_t const crc = ~a_Checksum;
+
+#if defined(HAKO_CRC32C_SSE42) || defined(HAKO_CRC32C_ARM)
+    static bool const hasHardwareCrc32c = HasHardwareCrc32c();
+    if (hasHardwareCrc32c)
+    {
+        return ~ComputeCrc32cHardware(data, a_NumBytes, crc);
+    }
+#endif
+
+    return ~ComputeCrc32cSoftware(data, a_NumBytes, crc);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hako
+{
+    /**
+     * Compute the CRC32C (Castagnoli) checksum of a block of data.
+     * Uses the CPU's CRC32 instructions where they are available (SSE4.2 on x86-64, the CRC extension on ARM64), and a table-driven implementation otherwise.
+     * @param a_Data The data to compute the checksum of
+     * @param a_NumBytes The size of a_Data
+     * @param a_Checksum The checksum of the data before a_Data, to compute a checksum over multiple blocks. 0 for the first block.
+     * @return The checksum of all data up to and including a_Data
+     */
+    uint32_t ComputeCrc32c(char const* a_Data, size_t a_NumBytes, uint32_t a_Checksum = 0);
+}
@@ -0,0 +1,402 @@
+#include "Compression.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+    /**
+     * Chunks are compressed with a byte-oriented LZ77 variant. A compressed chunk is a list of sequences, each consisting of:
+     * - A token byte. The high nibble holds the literal count, the low nibble the match length minus MinMatchLength. A nibble value of 15 means the length continues in extra bytes.
+     * - Extra literal count bytes: added to the literal count until a byte other than 255 is encountered
+     * - The literals
+     * - A little-endian uint16_t offset, pointing back into the output (omitted in the last sequence)
+     * - Extra match length bytes, encoded like the extra literal count bytes
+     */
+    constexpr size_t MinMatchLength = 4;
+    constexpr size_t MaxMatchOffset = 0xFFFF;
+    constexpr uint32_t HashBits = 14;
+    constexpr uint8_t ExtendedLength = 15;
+
+    static_assert(hako::CompressionChunkSize <= 0x10000, "Chunk positions are stored in 16 bits while compressing");
+
+    uint32_t Read32(uint8_t const* a_Data)
+    {
+        uint32_t value = 0;
+        memcpy(&value, a_Data, sizeof(value));
+        return value;
+    }
+
+    uint32_t HashSequence(uint32_t a_Sequence)
+    {
+        return (a_Sequence * 2654435761u) >> (32 - HashBits);
+    }
+
+    uint64_t ReadChunkEnd(char const* a_ChunkTable, size_t a_ChunkIndex)
+    {
+        auto const* bytes = reinterpret_cast<uint8_t const*>(a_ChunkTable + a_ChunkIndex * sizeof(uint64_t));
+
+        uint64_t value = 0;
+        for (size_t i = 0; i < sizeof(uint64_t); ++i)
+        {
+            value |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+        }
+
+        return value;
+    }
+
+    void WriteChunkEnd(char* a_ChunkTable, size_t a_ChunkIndex, uint64_t a_ChunkEnd)
+    {
+        auto* bytes = reinterpret_cast<uint8_t*>(a_ChunkTable + a_ChunkIndex * sizeof(uint64_t));
+
+        for (size_t i = 0; i < sizeof(uint64_t); ++i)
+        {
+            bytes[i] = static_cast<uint8_t>(a_ChunkEnd >> (i * 8));
+        }
+    }
+
+    /** @return The number of bytes needed to encode a length whose nibble in the token is ExtendedLength */
+    size_t GetExtendedLengthSize(size_t a_Length)
+    {
+        return a_Length >= ExtendedLength ? (a_Length - ExtendedLength) / 255 + 1 : 0;
+    }
+
+    uint8_t* WriteExtendedLength(uint8_t* a_Out, size_t a_Length)
+    {
+        a_Length -= ExtendedLength;
+        while (a_Length >= 255)
+        {
+            *a_Out++ = 255;
+            a_Length -= 255;
+        }
+
+        *a_Out++ = static_cast<uint8_t>(a_Length);
+        return a_Out;
+    }
+
+    bool ReadExtendedLength(uint8_t const*& a_In, uint8_t const* a_InEnd, size_t& a_Length)
+    {
+        uint8_t value = 0;
+        do
+        {
+            if (a_In == a_InEnd)
+            {
+                return false;
+            }
+
+            value = *a_In++;
+            a_Length += value;
+        } while (value == 255);
+
+        return true;
+    }
+
+    /**
+     * Write a sequence to the output
+     * @param a_MatchLength The length of the match, or 0 for the last sequence, which only contains literals
+     * @return The new output position, or a nullptr if the sequence doesn't fit in the output
+     */
+    uint8_t* WriteSequence(uint8_t* a_Out, uint8_t const* a_OutEnd, uint8_t const* a_Literals, size_t a_LiteralCount, size_t a_MatchOffset, size_t a_MatchLength)
+    {
+        size_t const encodedMatchLength = a_MatchLength > 0 ? a_MatchLength - MinMatchLength : 0;
+        size_t const sequenceSize = 1 + GetExtendedLengthSize(a_LiteralCount) + a_LiteralCount + (a_MatchLength > 0 ? 2 + GetExtendedLengthSize(encodedMatchLength) : 0);
+        if (sequenceSize > static_cast<size_t>(a_OutEnd - a_Out))
+        {
+            return nullptr;
+        }
+
+        uint8_t* token = a_Out++;
+        *token = static_cast<uint8_t>(std::min<size_t>(a_LiteralCount, ExtendedLength) << 4);
+        if (a_LiteralCount >= ExtendedLength)
+        {
+            a_Out = WriteExtendedLength(a_Out, a_LiteralCount);
+        }
+
+        memcpy(a_Out, a_Literals, a_LiteralCount);
+        a_Out += a_LiteralCount;
+
+        if (a_MatchLength > 0)
+        {
+            *token |= static_cast<uint8_t>(std::min<size_t>(encodedMatchLength, ExtendedLength));
+
+            *a_Out++ = static_cast<uint8_t>(a_MatchOffset & 0xFF);
+            *a_Out++ = static_cast<uint8_t>(a_MatchOffset >> 8);
+
+            if (encodedMatchLength >= ExtendedLength)
+            {
+                a_Out = WriteExtendedLength(a_Out, encodedMatchLength);
+            }
+        }
+
+        return a_Out;
+    }
+
+    /**
+     * Compress a single chunk
+     * @return The compressed size, or 0 if the compressed data doesn't fit in a_Capacity bytes
+     */
+    size_t CompressBlock(uint8_t const* a_Source, size_t a_SourceSize, uint8_t* a_Destination, size_t a_Capacity)
+    {
+        assert(a_SourceSize <= hako::CompressionChunkSize);
+
+        // Positions at which each hashed sequence was last seen
+        uint16_t positions[1 << HashBits] = {};
+
+        uint8_t* out = a_Destination;
+        uint8_t const* const outEnd = a_Destination + a_Capacity;
+
+        size_t anchor = 0;
+        size_t position = 0;
+
+        if (a_SourceSize >= MinMatchLength)
+        {
+            size_t const lastMatchPosition = a_SourceSize - MinMatchLength;
+
+            while (position <= lastMatchPosition)
+            {
+                uint32_t const sequence = Read32(a_Source + position);
+                uint32_t const hash = HashSequence(sequence);
+                size_t const candidate = positions[hash];
+                positions[hash] = static_cast<uint16_t>(position);
+
+                if (candidate < position && position - candidate <= MaxMatchOffset && Read32(a_Source + candidate) == sequence)
+                {
+                    size_t matchLength = MinMatchLength;
+                    while (position + matchLength < a_SourceSize && a_Source[candidate + matchLength] == a_Source[position + matchLength])
+                    {
+                        ++matchLength;
+                    }
+
+                    out = WriteSequence(out, outEnd, a_Source + anchor, position - anchor, position - candidate, matchLength);
+                    if (out == nullptr)
+                    {
+                        return 0;
+                    }
+
+                    position += matchLength;
+                    anchor = position;
+                }
+                else
+                {
+                    // Skip through incompressible data faster the longer we go without finding a match
+                    position += 1 + ((position - anchor) >> 6);
+                }
+            }
+        }
+
+        out = WriteSequence(out, outEnd, a_Source + anchor, a_SourceSize - anchor, 0, 0);
+        if (out == nullptr)
+        {
+            return 0;
+        }
+
+        return static_cast<size_t>(out - a_Destination);
+    }
+
+    bool DecompressBlock(uint8_t const* a_Source, size_t a_SourceSize, uint8_t* a_Destination, size_t a_DestinationSize)
+    {
+        uint8_t const* in = a_Source;
+        uint8_t const* const inEnd = a_Source + a_SourceSize;
+        uint8_t* out = a_Destination;
+        uint8_t const* const outEnd = a_Destination + a_DestinationSize;
+
+        while (in < inEnd)
+        {
+            uint8_t const token = *in++;
+
+            size_t literalCount = token >> 4;
+            if (literalCount == ExtendedLength && !ReadExtendedLength(in, inEnd, literalCount))
+            {
+                return false;
+            }
+
+            if (literalCount > static_cast<size_t>(inEnd - in) || literalCount > static_cast<size_t>(outEnd - out))
+            {
+                return false;
+            }
+
+            memcpy(out, in, literalCount);
+            in += literalCount;
+            out += literalCount;
+
+            if (in == inEnd)
+            {
+                // The last sequence only contains literals
+                break;
+            }
+
+            if (inEnd - in < 2)
+            {
+                return false;
+            }
+
+            size_t const matchOffset = static_cast<size_t>(in[0]) | (static_cast<size_t>(in[1]) << 8);
+            in += 2;
+
+            size_t matchLength = token & 0x0F;
+            if (matchLength == ExtendedLength && !ReadExtendedLength(in, inEnd, matchLength))
+            {
+                return false;
+            }
+            matchLength += MinMatchLength;
+
+            if (matchOffset == 0 || matchOffset > static_cast<size_t>(out - a_Destination) || matchLength > static_cast<size_t>(outEnd - out))
+            {
+                return false;
+            }
+
+            uint8_t const* match = out - matchOffset;
+            if (matchOffset >= matchLength)
+            {
+                memcpy(out, match, matchLength);
+            }
+            else
+            {
+                // Overlapping match, which repeats the last matchOffset bytes. Copies of up to matchOffset bytes never overlap.
+                size_t copied = 0;
+                if (matchOffset >= sizeof(uint64_t))
+                {
+                    for (; copied + sizeof(uint64_t) <= matchLength; copied += sizeof(uint64_t))
+                    {
+                        memcpy(out + copied, match + copied, sizeof(uint64_t));
+                    }
+                }
+
+                for (; copied < matchLength; ++copied)
+                {
+                    out[copied] = match[copied];
+                }
+            }
+
+            out += matchLength;
+        }
+
+        return out == outEnd;
+    }
+}
+
+bool hako::CompressChunked(char const* a_Data, size_t a_Size, std::vector<char>& a_OutCompressedData)
+{
+    size_t const chunkCount = GetCompressionChunkCount(a_Size);
+    size_t const chunkTableSize = GetCompressionChunkTableSize(a_Size);
+
+    a_OutCompressedData.clear();
+    a_OutCompressedData.reserve(chunkTableSize + a_Size);
+    a_OutCompressedData.resize(chunkTableSize);
+
+    size_t chunkDataSize = 0;
+
+    for (size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+    {
+        size_t const rawOffset = chunkIndex * CompressionChunkSize;
+        size_t const rawChunkSize = std::min(CompressionChunkSize, a_Size - rawOffset);
+
+        a_OutCompressedData.resize(chunkTableSize + chunkDataSize + rawChunkSize);
+        char* const chunkData = a_OutCompressedData.data() + chunkTableSize + chunkDataSize;
+
+        // Only keep the compressed chunk if it's smaller than the original, so the stored size tells us whether the chunk was compressed
+        size_t storedChunkSize = CompressBlock(reinterpret_cast<uint8_t const*>(a_Data + rawOffset), rawChunkSize, reinterpret_cast<uint8_t*>(chunkData), rawChunkSize - 1);
+        if (storedChunkSize == 0)
+        {
+            memcpy(chunkData, a_Data + rawOffset, rawChunkSize);
+            storedChunkSize = rawChunkSize;
+        }
+
+        chunkDataSize += storedChunkSize;
+        a_OutCompressedData.resize(chunkTableSize + chunkDataSize);
+        WriteChunkEnd(a_OutCompressedData.data(), chunkIndex, chunkDataSize);
+    }
+
+    return a_OutCompressedData.size() < a_Size;
+}
+
+void hako::GetChunkDataRange(char const* a_ChunkTable, size_t a_RawSize, size_t a_RawOffset, size_t a_NumBytes, size_t& a_OutDataOffset, size_t& a_OutDataSize)
+{
+    a_OutDataOffset = 0;
+    a_OutDataSize = 0;
+
+    if (a_NumBytes == 0 || a_RawOffset >= a_RawSize)
+    {
+        return;
+    }
+
+    size_t const firstChunk = a_RawOffset / CompressionChunkSize;
+    size_t const lastChunk = (std::min(a_RawOffset + a_NumBytes, a_RawSize) - 1) / CompressionChunkSize;
+
+    size_t const dataStart = firstChunk == 0 ? 0 : ReadChunkEnd(a_ChunkTable, firstChunk - 1);
+    size_t const dataEnd = ReadChunkEnd(a_ChunkTable, lastChunk);
+
+    a_OutDataOffset = dataStart;
+    a_OutDataSize = dataEnd > dataStart ? dataEnd - dataStart : 0;
+}
+
+bool hako::DecompressChunked(char const* a_ChunkTable, size_t a_RawSize, char const* a_ChunkData, size_t a_ChunkDataOffset, size_t a_ChunkDataSize,
+    size_t a_RawOffset, size_t a_NumBytes, char* a_OutBuffer)
+{
+    if (a_NumBytes == 0)
+    {
+        return true;
+    }
+
+    if (a_RawOffset > a_RawSize || a_NumBytes > a_RawSize - a_RawOffset)
+    {
+        return false;
+    }
+
+    size_t const firstChunk = a_RawOffset / CompressionChunkSize;
+    size_t const lastChunk = (a_RawOffset + a_NumBytes - 1) / CompressionChunkSize;
+
+    std::vector<char> partialChunk{};
+
+    for (size_t chunkIndex = firstChunk; chunkIndex <= lastChunk; ++chunkIndex)
+    {
+        size_t const chunkStart = chunkIndex == 0 ? 0 : ReadChunkEnd(a_ChunkTable, chunkIndex - 1);
+        size_t const chunkEnd = ReadChunkEnd(a_ChunkTable, chunkIndex);
+        if (chunkEnd < chunkStart || chunkStart < a_ChunkDataOffset || chunkEnd - a_ChunkDataOffset > a_ChunkDataSize)
+        {
+            return false;
+        }
+
+        size_t const rawChunkOffset = chunkIndex * CompressionChunkSize;
+        size_t const rawChunkSize = std::min(CompressionChunkSize, a_RawSize - rawChunkOffset);
+        size_t const storedChunkSize = chunkEnd - chunkStart;
+        if (storedChunkSize > rawChunkSize)
+        {
+            return false;
+        }
+
+        // The part of this chunk that was requested
+        size_t const copyStart = std::max(a_RawOffset, rawChunkOffset) - rawChunkOffset;
+        size_t const copyEnd = std::min(a_RawOffset + a_NumBytes, rawChunkOffset + rawChunkSize) - rawChunkOffset;
+        char* const out = a_OutBuffer + (rawChunkOffset + copyStart - a_RawOffset);
+
+        char const* const storedChunk = a_ChunkData + (chunkStart - a_ChunkDataOffset);
+
+        if (storedChunkSize == rawChunkSize)
+        {
+            // Chunk is stored uncompressed
+            memcpy(out, storedChunk + copyStart, copyEnd - copyStart);
+        }
+        else if (copyStart == 0 && copyEnd == rawChunkSize)
+        {
+            if (!DecompressBlock(reinterpret_cast<uint8_t const*>(storedChunk), storedChunkSize, reinterpret_cast<uint8_t*>(out), rawChunkSize))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // Only part of the chunk is needed, so decompress it elsewhere first
+            partialChunk.resize(rawChunkSize);
+            if (!DecompressBlock(reinterpret_cast<uint8_t const*>(storedChunk), storedChunkSize, reinterpret_cast<uint8_t*>(partialChunk.data()), rawChunkSize))
+            {
+                return false;
+            }
+
+            memcpy(out, partialChunk.data() + copyStart, copyEnd - copyStart);
+        }
+    }
+
+    return true;
+}
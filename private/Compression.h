@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hako
+{
+    /**
+     * Compressed files are split into chunks of this size (before compression), which are compressed independently.
+     * This allows reading part of a file without decompressing everything before it.
+     */
+    constexpr size_t CompressionChunkSize = 64 * 1024;
+
+    /**
+     * Compressed file layout:
+     * - Chunk table: one little-endian uint64_t per chunk, containing the offset at which the chunk's data ends, relative to the end of the chunk table
+     * - Chunk data: each chunk is either LZ-compressed, or stored as-is if compression did not make it smaller (in which case its stored size equals its original size)
+     */
+
+    /**
+     * @param a_RawSize The size of the file before compression
+     * @return The number of chunks the file is split into
+     */
+    constexpr size_t GetCompressionChunkCount(size_t a_RawSize)
+    {
+        return (a_RawSize + CompressionChunkSize - 1) / CompressionChunkSize;
+    }
+
+    /**
+     * @param a_RawSize The size of the file before compression
+     * @return The size of the chunk table at the start of the compressed file
+     */
+    constexpr size_t GetCompressionChunkTableSize(size_t a_RawSize)
+    {
+        return GetCompressionChunkCount(a_RawSize) * sizeof(uint64_t);
+    }
+
+    /**
+     * Compress a file into chunks
+     * @param a_Data The file content to compress
+     * @param a_Size The size of the file content
+     * @param a_OutCompressedData The vector to output the chunk table and compressed chunks into
+     * @return True if the file was compressed, or false if compressing the file would not make it smaller
+     */
+    bool CompressChunked(char const* a_Data, size_t a_Size, std::vector<char>& a_OutCompressedData);
+
+    /**
+     * Get the range of chunk data that has to be read to decompress part of a file
+     * @param a_ChunkTable The file's chunk table
+     * @param a_RawSize The size of the file before compression
+     * @param a_RawOffset The offset (in the decompressed file) of the first byte that is needed
+     * @param a_NumBytes The number of decompressed bytes that are needed
+     * @param a_OutDataOffset The offset of the first needed byte of chunk data, relative to the end of the chunk table (out)
+     * @param a_OutDataSize The number of bytes of chunk data that are needed (out)
+     */
+    void GetChunkDataRange(char const* a_ChunkTable, size_t a_RawSize, size_t a_RawOffset, size_t a_NumBytes, size_t& a_OutDataOffset, size_t& a_OutDataSize);
+
+    /**
+     * Decompress part of a chunked file
+     * @param a_ChunkTable The file's chunk table
+     * @param a_RawSize The size of the file before compression
+     * @param a_ChunkData Chunk data, starting at a_ChunkDataOffset and covering at least the range returned by GetChunkDataRange()
+     * @param a_ChunkDataOffset The offset of a_ChunkData relative to the end of the chunk table
+     * @param a_ChunkDataSize The number of bytes available in a_ChunkData
+     * @param a_RawOffset The offset (in the decompressed file) of the first byte to output
+     * @param a_NumBytes The number of decompressed bytes to output
+     * @param a_OutBuffer The buffer to decompress into. Should be at least a_NumBytes in size.
+     * @return True if the data was decompressed successfully, or false if the compressed data is corrupted
+     */
+    bool DecompressChunked(char const* a_ChunkTable, size_t a_RawSize, char const* a_ChunkData, size_t a_ChunkDataOffset, size_t a_ChunkDataSize,
+        size_t a_RawOffset, size_t a_NumBytes, char* a_OutBuffer);
+}
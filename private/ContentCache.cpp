@@ -0,0 +1,91 @@
+#include "ContentCache.h"
+
+using namespace hako;
+
+void ContentCache::SetBudget(size_t a_Budget)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Budget.store(a_Budget, std::memory_order_relaxed);
+    EvictToBudget();
+}
+
+bool ContentCache::IsEnabled() const
+{
+    return m_Budget.load(std::memory_order_relaxed) > 0;
+}
+
+ContentCache::Buffer ContentCache::Find(ResourcePathHash const& a_ResourcePathHash)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto const it = m_EntryLookup.find(a_ResourcePathHash);
+    if (it == m_EntryLookup.end())
+    {
+        ++m_MissCount;
+        return nullptr;
+    }
+
+    ++m_HitCount;
+    m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+    return it->second->m_Buffer;
+}
+
+void ContentCache::Insert(ResourcePathHash const& a_ResourcePathHash, Buffer a_Buffer)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (a_Buffer == nullptr || a_Buffer->size() > m_Budget.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    // Another thread might have loaded the same file in the meantime
+    auto const it = m_EntryLookup.find(a_ResourcePathHash);
+    if (it != m_EntryLookup.end())
+    {
+        m_CachedBytes -= it->second->m_Buffer->size();
+        m_Entries.erase(it->second);
+        m_EntryLookup.erase(it);
+    }
+
+    m_CachedBytes += a_Buffer->size();
+    m_Entries.push_front({ a_ResourcePathHash, std::move(a_Buffer) });
+    m_EntryLookup.emplace(a_ResourcePathHash, m_Entries.begin());
+
+    EvictToBudget();
+}
+
+void ContentCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Entries.clear();
+    m_EntryLookup.clear();
+    m_CachedBytes = 0;
+}
+
+ContentCacheStats ContentCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    ContentCacheStats stats;
+    stats.m_HitCount = m_HitCount;
+    stats.m_MissCount = m_MissCount;
+    stats.m_CachedBytes = m_CachedBytes;
+    stats.m_CachedFileCount = m_Entries.size();
+    stats.m_Budget = m_Budget.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ContentCache::EvictToBudget()
+{
+    size_t const budget = m_Budget.load(std::memory_order_relaxed);
+    while (m_CachedBytes > budget)
+    {
+        Entry const& leastRecentlyUsed = m_Entries.back();
+        m_CachedBytes -= leastRecentlyUsed.m_Buffer->size();
+        m_EntryLookup.erase(leastRecentlyUsed.m_ResourcePathHash);
+        m_Entries.pop_back();
+    }
+}
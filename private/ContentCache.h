@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Hako.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace hako
+{
+    /**
+     * Least-recently-used cache of file content with a byte budget. Safe to use from multiple threads at once.
+     */
+    class ContentCache final
+    {
+    public:
+        using Buffer = std::shared_ptr<std::vector<char> const>;
+
+    public:
+        /**
+         * Set the maximum number of bytes of file content to keep cached. Evicts files if the cache is over budget.
+         * @param a_Budget The budget in bytes. A budget of 0 disables the cache.
+         */
+        void SetBudget(size_t a_Budget);
+
+        /**
+         * @return True if the cache has a budget to store files in. Doesn't lock the cache, so checking it on every read is cheap.
+         */
+        bool IsEnabled() const;
+
+        /**
+         * Find a cached file and mark it as most recently used. Counts as a hit or a miss.
+         * @param a_ResourcePathHash The hash of the file to find
+         * @return The file's content, or a nullptr if the file is not cached
+         */
+        Buffer Find(ResourcePathHash const& a_ResourcePathHash);
+
+        /**
+         * Add a file to the cache, evicting the least recently used files if needed. Files larger than the budget are not cached.
+         * @param a_ResourcePathHash The hash of the file
+         * @param a_Buffer The file's content
+         */
+        void Insert(ResourcePathHash const& a_ResourcePathHash, Buffer a_Buffer);
+
+        /**
+         * Remove all files from the cache. Buffers that were handed out stay valid.
+         */
+        void Clear();
+
+        ContentCacheStats GetStats() const;
+
+    private:
+        struct Entry
+        {
+            ResourcePathHash m_ResourcePathHash;
+            Buffer m_Buffer;
+        };
+
+        /** Evict least recently used files until the cache is within its budget. Expects m_Mutex to be locked. */
+        void EvictToBudget();
+
+    private:
+        mutable std::mutex m_Mutex;
+
+        /** Cached files, from most to least recently used */
+        std::list<Entry> m_Entries;
+        std::unordered_map<ResourcePathHash, std::list<Entry>::iterator> m_EntryLookup;
+
+        /** Only changed while m_Mutex is locked, but read without locking it by IsEnabled() */
+        std::atomic<size_t> m_Budget = 0;
+        size_t m_CachedBytes = 0;
+        uint64_t m_HitCount = 0;
+        uint64_t m_MissCount = 0;
+    };
+}
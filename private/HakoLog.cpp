@@ -2,6 +2,7 @@
 
 #include <cstdio>
 #include <cstdarg>
+#include <cwchar>
 
 void hako::Log(char const* a_Format, ...)
 {
@@ -0,0 +1,199 @@
+#include "IntermediateOverlay.h"
+#include "HakoLog.h"
+
+#include <cstring>
+#include <mutex>
+
+#if defined(HAKO_WATCH_INTERMEDIATE_DIRECTORY)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace hako;
+
+namespace
+{
+    /** Length of an intermediate file's name, which is its hash in hexadecimal */
+    constexpr size_t IntermediateFileNameLength = 32;
+
+    bool IsHexadecimal(std::string const& a_String)
+    {
+        return a_String.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos;
+    }
+}
+
+IntermediateOverlay::IntermediateOverlay(std::filesystem::path a_Directory, std::filesystem::file_time_type a_ArchiveWriteTime)
+    : m_Directory(std::move(a_Directory))
+    , m_ArchiveWriteTime(a_ArchiveWriteTime)
+{
+#if defined(HAKO_WATCH_INTERMEDIATE_DIRECTORY)
+    // Start watching before scanning, so files that are written during the scan aren't missed
+    m_IsWatching = StartWatching();
+#endif
+
+    if (m_IsWatching)
+    {
+        std::unique_lock<std::shared_mutex> lock(m_NewerFilesMutex);
+        ScanDirectory();
+    }
+}
+
+IntermediateOverlay::~IntermediateOverlay()
+{
+#if defined(HAKO_WATCH_INTERMEDIATE_DIRECTORY)
+    if (m_WatchThread.joinable())
+    {
+        char const stop = 0;
+        (void)write(m_StopPipe[1], &stop, sizeof(stop));
+        m_WatchThread.join();
+    }
+
+    for (int const descriptor : { m_InotifyDescriptor, m_StopPipe[0], m_StopPipe[1] })
+    {
+        if (descriptor >= 0)
+        {
+            close(descriptor);
+        }
+    }
+#endif
+}
+
+bool IntermediateOverlay::HasNewerFile(ResourcePathHash const& a_ResourcePathHash) const
+{
+    if (!m_IsWatching)
+    {
+        ResourcePathHash hash;
+        return IsNewerIntermediateFile(a_ResourcePathHash.ToString(), hash);
+    }
+
+    std::shared_lock<std::shared_mutex> lock(m_NewerFilesMutex);
+    return m_NewerFiles.count(a_ResourcePathHash) > 0;
+}
+
+bool IntermediateOverlay::IsNewerIntermediateFile(std::filesystem::path const& a_FileName, ResourcePathHash& a_OutResourcePathHash) const
+{
+    std::string const fileName = a_FileName.filename().string();
+    if (fileName.size() != IntermediateFileNameLength || !IsHexadecimal(fileName))
+    {
+        return false;
+    }
+
+    std::error_code error{};
+    auto const writeTime = std::filesystem::last_write_time(m_Directory / fileName, error);
+    if (error || writeTime <= m_ArchiveWriteTime)
+    {
+        return false;
+    }
+
+    a_OutResourcePathHash = ResourcePathHash::FromString(fileName.c_str());
+    return true;
+}
+
+void IntermediateOverlay::ScanDirectory()
+{
+    m_NewerFiles.clear();
+
+    std::error_code error{};
+    std::filesystem::directory_iterator const directory(m_Directory, std::filesystem::directory_options::skip_permission_denied, error);
+    if (error)
+    {
+        return;
+    }
+
+    for (std::filesystem::directory_entry const& entry : directory)
+    {
+        ResourcePathHash hash;
+        if (entry.is_regular_file(error) && IsNewerIntermediateFile(entry.path(), hash))
+        {
+            m_NewerFiles.insert(hash);
+        }
+    }
+}
+
+#if defined(HAKO_WATCH_INTERMEDIATE_DIRECTORY)
+bool IntermediateOverlay::StartWatching()
+{
+    m_InotifyDescriptor = inotify_init1(IN_CLOEXEC);
+    if (m_InotifyDescriptor < 0 || pipe2(m_StopPipe, O_CLOEXEC) != 0)
+    {
+        return false;
+    }
+
+    // Intermediate files are written in place by ExportResource() and serializers, or copied over
+    uint32_t const events = IN_CLOSE_WRITE | IN_MOVED_TO | IN_ATTRIB | IN_DELETE | IN_MOVED_FROM;
+    if (inotify_add_watch(m_InotifyDescriptor, m_Directory.c_str(), events) < 0)
+    {
+        return false;
+    }
+
+    m_WatchThread = std::thread(&IntermediateOverlay::WatchLoop, this);
+    return true;
+}
+
+void IntermediateOverlay::WatchLoop()
+{
+    alignas(inotify_event) char buffer[16 * 1024];
+
+    while (true)
+    {
+        pollfd descriptors[2] = { { m_InotifyDescriptor, POLLIN, 0 }, { m_StopPipe[0], POLLIN, 0 } };
+        if (poll(descriptors, 2, -1) < 0 || descriptors[1].revents != 0)
+        {
+            return;
+        }
+
+        ssize_t const bytesRead = read(m_InotifyDescriptor, buffer, sizeof(buffer));
+        if (bytesRead <= 0)
+        {
+            continue;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(m_NewerFilesMutex);
+        for (char const* eventStart = buffer; eventStart < buffer + bytesRead;)
+        {
+            inotify_event event{};
+            memcpy(&event, eventStart, sizeof(inotify_event));
+            char const* const eventName = eventStart + sizeof(inotify_event);
+            eventStart += sizeof(inotify_event) + event.len;
+
+            if ((event.mask & IN_Q_OVERFLOW) != 0)
+            {
+                // Events were dropped, so the only way to catch up is to look at the directory again
+                hako::Log("Too many changes to intermediate directory \"%s\" to keep track of. Rescanning it.\n", m_Directory.string().c_str());
+                ScanDirectory();
+                continue;
+            }
+
+            if ((event.mask & IN_IGNORED) != 0)
+            {
+                // The directory was deleted or unmounted, so no more events will come in
+                hako::Log("Stopped watching intermediate directory \"%s\". Reads will check the file system instead.\n", m_Directory.string().c_str());
+                m_IsWatching = false;
+                return;
+            }
+
+            if (event.len == 0)
+            {
+                continue;
+            }
+
+            std::filesystem::path const fileName(eventName);
+            ResourcePathHash hash;
+            if ((event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+            {
+                std::string const name = fileName.string();
+                if (name.size() == IntermediateFileNameLength && IsHexadecimal(name))
+                {
+                    m_NewerFiles.erase(ResourcePathHash::FromString(name.c_str()));
+                }
+            }
+            else if (IsNewerIntermediateFile(fileName, hash))
+            {
+                m_NewerFiles.insert(hash);
+            }
+        }
+    }
+}
+#endif
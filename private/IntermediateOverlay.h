@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ResourcePathHash.h"
+
+#include <atomic>
+#include <filesystem>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_set>
+
+#if defined(__linux__)
+// Watch the intermediate directory with inotify instead of checking the file system on every lookup
+#define HAKO_WATCH_INTERMEDIATE_DIRECTORY
+#endif
+
+namespace hako
+{
+    /**
+     * Keeps track of which intermediate files are newer than an archive, so reads outside of the archive don't need to touch the file system for every file.
+     * The intermediate directory is scanned once, after which changes are picked up by watching the directory.
+     * Where the directory can't be watched, every lookup checks the file system instead.
+     */
+    class IntermediateOverlay final
+    {
+    public:
+        /**
+         * @param a_Directory The directory that holds the intermediate files for the current platform
+         * @param a_ArchiveWriteTime The time at which the archive was last written to. Intermediate files written after this are considered newer.
+         */
+        IntermediateOverlay(std::filesystem::path a_Directory, std::filesystem::file_time_type a_ArchiveWriteTime);
+        /**
+         * Stops watching the intermediate directory
+         */
+        ~IntermediateOverlay();
+
+        IntermediateOverlay(IntermediateOverlay&) = delete;
+        IntermediateOverlay(IntermediateOverlay const&) = delete;
+        IntermediateOverlay& operator=(IntermediateOverlay const&) = delete;
+        IntermediateOverlay(IntermediateOverlay&&) = delete;
+        IntermediateOverlay& operator=(IntermediateOverlay&&) = delete;
+
+        /**
+         * @param a_ResourcePathHash The hash of the file to check
+         * @return True if the file's intermediate file was written after the archive
+         */
+        bool HasNewerFile(ResourcePathHash const& a_ResourcePathHash) const;
+
+    private:
+        /**
+         * Check a single intermediate file on the file system
+         * @param a_FileName The intermediate file's name
+         * @param a_OutResourcePathHash The hash the file belongs to (out)
+         * @return True if the file is an intermediate file that is newer than the archive
+         */
+        bool IsNewerIntermediateFile(std::filesystem::path const& a_FileName, ResourcePathHash& a_OutResourcePathHash) const;
+
+        /**
+         * Replace m_NewerFiles with all intermediate files that are currently newer than the archive. Expects m_NewerFilesMutex to be locked exclusively.
+         */
+        void ScanDirectory();
+
+#if defined(HAKO_WATCH_INTERMEDIATE_DIRECTORY)
+        /**
+         * Start watching the intermediate directory for changes
+         * @return True if the directory is being watched
+         */
+        bool StartWatching();
+
+        /**
+         * Update m_NewerFiles as changes to the intermediate directory come in, until the overlay is destroyed
+         */
+        void WatchLoop();
+#endif
+
+    private:
+        std::filesystem::path m_Directory{};
+        std::filesystem::file_time_type m_ArchiveWriteTime{};
+
+        /** Hashes of intermediate files that are newer than the archive */
+        std::unordered_set<ResourcePathHash> m_NewerFiles{};
+        mutable std::shared_mutex m_NewerFilesMutex;
+
+        /** True if m_NewerFiles is kept up to date. If false, lookups check the file system instead. */
+        std::atomic<bool> m_IsWatching = false;
+
+#if defined(HAKO_WATCH_INTERMEDIATE_DIRECTORY)
+        int m_InotifyDescriptor = -1;
+        /** Written to when the overlay is destroyed, to wake up the watch thread */
+        int m_StopPipe[2] = { -1, -1 };
+        std::thread m_WatchThread{};
+#endif
+    };
+}
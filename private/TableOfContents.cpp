@@ -0,0 +1,237 @@
+#include "TableOfContents.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace hako;
+
+namespace
+{
+    /**
+     * Byte offsets of the table's arrays from the start of the table
+     */
+    struct TableLayout
+    {
+        size_t m_Hashes = 0;
+        size_t m_Offsets = 0;
+        size_t m_Sizes = 0;
+        size_t m_StoredSizes = 0;
+        size_t m_Checksums = 0;
+        size_t m_Compressions = 0;
+        size_t m_End = 0;
+    };
+
+    size_t AlignArray(size_t a_Offset)
+    {
+        return (a_Offset + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+    }
+
+    TableLayout GetTableLayout(size_t a_FileCount, uint8_t a_Flags)
+    {
+        size_t const hashSize = (a_Flags & TableOfContents::Flag64BitHashes) != 0 ? sizeof(uint64_t) : sizeof(ResourcePathHash);
+        size_t const offsetSize = (a_Flags & TableOfContents::Flag32BitOffsets) != 0 ? sizeof(uint32_t) : sizeof(uint64_t);
+
+        TableLayout layout{};
+        layout.m_Offsets = AlignArray(layout.m_Hashes + a_FileCount * hashSize);
+        layout.m_Sizes = AlignArray(layout.m_Offsets + a_FileCount * offsetSize);
+        layout.m_StoredSizes = AlignArray(layout.m_Sizes + a_FileCount * offsetSize);
+        layout.m_Checksums = AlignArray(layout.m_StoredSizes + a_FileCount * offsetSize);
+        layout.m_Compressions = AlignArray(layout.m_Checksums + a_FileCount * sizeof(uint32_t));
+        layout.m_End = AlignArray(layout.m_Compressions + a_FileCount * sizeof(Compression));
+
+        return layout;
+    }
+
+    template<typename T>
+    void WriteElement(char* a_Array, size_t a_Index, T a_Value)
+    {
+        memcpy(a_Array + a_Index * sizeof(T), &a_Value, sizeof(T));
+    }
+}
+
+size_t TableOfContents::GetSize(size_t a_FileCount, uint8_t a_Flags)
+{
+    return GetTableLayout(a_FileCount, a_Flags).m_End;
+}
+
+void TableOfContents::Serialize(std::vector<Archive::FileInfo> const& a_Files, uint8_t a_Flags, std::vector<char>& a_OutData)
+{
+    TableLayout const layout = GetTableLayout(a_Files.size(), a_Flags);
+    bool const shortHashes = (a_Flags & Flag64BitHashes) != 0;
+    bool const shortOffsets = (a_Flags & Flag32BitOffsets) != 0;
+
+    a_OutData.clear();
+    a_OutData.resize(layout.m_End);
+    char* const data = a_OutData.data();
+
+    for (size_t fileIndex = 0; fileIndex < a_Files.size(); ++fileIndex)
+    {
+        Archive::FileInfo const& fi = a_Files[fileIndex];
+
+        if (shortHashes)
+        {
+            WriteElement(data + layout.m_Hashes, fileIndex, fi.m_ResourcePathHash.hash64[0]);
+        }
+        else
+        {
+            WriteElement(data + layout.m_Hashes, fileIndex, fi.m_ResourcePathHash);
+        }
+
+        if (shortOffsets)
+        {
+            WriteElement(data + layout.m_Offsets, fileIndex, static_cast<uint32_t>(fi.m_Offset));
+            WriteElement(data + layout.m_Sizes, fileIndex, static_cast<uint32_t>(fi.m_Size));
+            WriteElement(data + layout.m_StoredSizes, fileIndex, static_cast<uint32_t>(fi.m_StoredSize));
+        }
+        else
+        {
+            WriteElement(data + layout.m_Offsets, fileIndex, static_cast<uint64_t>(fi.m_Offset));
+            WriteElement(data + layout.m_Sizes, fileIndex, static_cast<uint64_t>(fi.m_Size));
+            WriteElement(data + layout.m_StoredSizes, fileIndex, static_cast<uint64_t>(fi.m_StoredSize));
+        }
+
+        WriteElement(data + layout.m_Checksums, fileIndex, fi.m_Checksum);
+        WriteElement(data + layout.m_Compressions, fileIndex, fi.m_Compression);
+    }
+}
+
+void TableOfContents::Allocate(size_t a_FileCount, uint8_t a_Flags)
+{
+    TableLayout const layout = GetTableLayout(a_FileCount, a_Flags);
+    bool const shortHashes = (a_Flags & Flag64BitHashes) != 0;
+    bool const shortOffsets = (a_Flags & Flag32BitOffsets) != 0;
+
+    Clear();
+    m_Data.resize(layout.m_End / sizeof(uint64_t));
+    m_FileCount = a_FileCount;
+    m_Flags = a_Flags;
+
+    char const* const data = reinterpret_cast<char const*>(m_Data.data());
+
+    if (shortHashes)
+    {
+        m_ShortHashes = reinterpret_cast<uint64_t const*>(data + layout.m_Hashes);
+    }
+    else
+    {
+        m_Hashes = reinterpret_cast<ResourcePathHash const*>(data + layout.m_Hashes);
+    }
+
+    if (shortOffsets)
+    {
+        m_ShortOffsets = reinterpret_cast<uint32_t const*>(data + layout.m_Offsets);
+        m_ShortSizes = reinterpret_cast<uint32_t const*>(data + layout.m_Sizes);
+        m_ShortStoredSizes = reinterpret_cast<uint32_t const*>(data + layout.m_StoredSizes);
+    }
+    else
+    {
+        m_Offsets = reinterpret_cast<uint64_t const*>(data + layout.m_Offsets);
+        m_Sizes = reinterpret_cast<uint64_t const*>(data + layout.m_Sizes);
+        m_StoredSizes = reinterpret_cast<uint64_t const*>(data + layout.m_StoredSizes);
+    }
+
+    m_Checksums = reinterpret_cast<uint32_t const*>(data + layout.m_Checksums);
+    m_Compressions = reinterpret_cast<Compression const*>(data + layout.m_Compressions);
+}
+
+void TableOfContents::Clear()
+{
+    m_Data.clear();
+    m_Data.shrink_to_fit();
+    m_FileCount = 0;
+    m_Flags = 0;
+
+    m_Hashes = nullptr;
+    m_ShortHashes = nullptr;
+    m_Offsets = nullptr;
+    m_ShortOffsets = nullptr;
+    m_Sizes = nullptr;
+    m_ShortSizes = nullptr;
+    m_StoredSizes = nullptr;
+    m_ShortStoredSizes = nullptr;
+    m_Checksums = nullptr;
+    m_Compressions = nullptr;
+}
+
+char* TableOfContents::GetData()
+{
+    return reinterpret_cast<char*>(m_Data.data());
+}
+
+size_t TableOfContents::GetFileCount() const
+{
+    return m_FileCount;
+}
+
+uint8_t TableOfContents::GetFlags() const
+{
+    return m_Flags;
+}
+
+size_t TableOfContents::Find(ResourcePathHash const& a_ResourcePathHash, size_t a_First, size_t a_End) const
+{
+    if (m_ShortHashes != nullptr)
+    {
+        uint64_t const key = a_ResourcePathHash.hash64[0];
+        uint64_t const* const found = std::lower_bound(m_ShortHashes + a_First, m_ShortHashes + a_End, key);
+        return found != m_ShortHashes + a_End && *found == key ? static_cast<size_t>(found - m_ShortHashes) : NotFound;
+    }
+
+    ResourcePathHash const* const found = std::lower_bound(m_Hashes + a_First, m_Hashes + a_End, a_ResourcePathHash);
+    return found != m_Hashes + a_End && *found == a_ResourcePathHash ? static_cast<size_t>(found - m_Hashes) : NotFound;
+}
+
+ResourcePathHash TableOfContents::GetHash(size_t a_FileIndex) const
+{
+    if (m_ShortHashes != nullptr)
+    {
+        ResourcePathHash hash{};
+        hash.hash64[0] = m_ShortHashes[a_FileIndex];
+        return hash;
+    }
+
+    return m_Hashes[a_FileIndex];
+}
+
+bool TableOfContents::HasHash(size_t a_FileIndex, ResourcePathHash const& a_ResourcePathHash) const
+{
+    if (m_ShortHashes != nullptr)
+    {
+        return m_ShortHashes[a_FileIndex] == a_ResourcePathHash.hash64[0];
+    }
+
+    return m_Hashes[a_FileIndex] == a_ResourcePathHash;
+}
+
+bool TableOfContents::IsSortedAfterPrevious(size_t a_FileIndex) const
+{
+    if (m_ShortHashes != nullptr)
+    {
+        return m_ShortHashes[a_FileIndex - 1] < m_ShortHashes[a_FileIndex];
+    }
+
+    return m_Hashes[a_FileIndex - 1] < m_Hashes[a_FileIndex];
+}
+
+Archive::FileInfo TableOfContents::GetFileInfo(size_t a_FileIndex) const
+{
+    Archive::FileInfo fi{};
+    fi.m_ResourcePathHash = GetHash(a_FileIndex);
+    fi.m_Compression = m_Compressions[a_FileIndex];
+    fi.m_Checksum = m_Checksums[a_FileIndex];
+
+    if (m_ShortOffsets != nullptr)
+    {
+        fi.m_Offset = m_ShortOffsets[a_FileIndex];
+        fi.m_Size = m_ShortSizes[a_FileIndex];
+        fi.m_StoredSize = m_ShortStoredSizes[a_FileIndex];
+    }
+    else
+    {
+        fi.m_Offset = m_Offsets[a_FileIndex];
+        fi.m_Size = m_Sizes[a_FileIndex];
+        fi.m_StoredSize = m_StoredSizes[a_FileIndex];
+    }
+
+    return fi;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Hako.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace hako
+{
+    /**
+     * An archive's table of contents, stored as a structure of arrays: hashes, offsets, sizes, stored sizes, checksums and compression methods each live in their own array, sorted by hash.
+     * Lookups only touch the hash array. The table has the same layout on disk and in memory, so it is loaded with a single read.
+     * Archives can narrow hashes to their first 64 bits, and offsets and sizes to 32 bits, which more than halves the memory the table takes up.
+     */
+    class TableOfContents final
+    {
+    public:
+        /** Hashes are narrowed to their first 64 bits (hash64[0]) */
+        static constexpr uint8_t Flag64BitHashes = 1 << 0;
+        /** Offsets, sizes and stored sizes are narrowed to 32 bits */
+        static constexpr uint8_t Flag32BitOffsets = 1 << 1;
+        static constexpr uint8_t ValidFlags = Flag64BitHashes | Flag32BitOffsets;
+
+        /** Returned by Find() if a file is not in the table */
+        static constexpr size_t NotFound = ~size_t{ 0 };
+
+        /**
+         * @param a_FileCount The number of files in the table
+         * @param a_Flags The table's flags
+         * @return The size of the table in bytes, both in the archive and in memory
+         */
+        static size_t GetSize(size_t a_FileCount, uint8_t a_Flags);
+
+        /**
+         * Serialize a table of contents to write it to an archive
+         * @param a_Files Info on all files, sorted by hash. The files' offsets and sizes have to fit into 32 bits if a_Flags contains Flag32BitOffsets.
+         * @param a_Flags The table's flags
+         * @param a_OutData The vector to write the table into. Its previous content is replaced.
+         */
+        static void Serialize(std::vector<Archive::FileInfo> const& a_Files, uint8_t a_Flags, std::vector<char>& a_OutData);
+
+    public:
+        /**
+         * Allocate an empty table, which is filled by reading GetSize() bytes into GetData()
+         * @param a_FileCount The number of files in the table
+         * @param a_Flags The table's flags. Must only contain ValidFlags.
+         */
+        void Allocate(size_t a_FileCount, uint8_t a_Flags);
+
+        /**
+         * Remove all files from the table and release its memory
+         */
+        void Clear();
+
+        /**
+         * @return The table's serialized data, GetSize(GetFileCount(), GetFlags()) bytes
+         */
+        char* GetData();
+
+        size_t GetFileCount() const;
+
+        uint8_t GetFlags() const;
+
+        /**
+         * Find a file with a binary search over part of the table
+         * @param a_ResourcePathHash The hash of the file to find. Only its first 64 bits are compared if the table has 64-bit hashes.
+         * @param a_First The index of the first file to search
+         * @param a_End The index after the last file to search
+         * @return The index of the file, or NotFound if it is not in the range
+         */
+        size_t Find(ResourcePathHash const& a_ResourcePathHash, size_t a_First, size_t a_End) const;
+
+        /**
+         * @return The hash of a file. Only the first 64 bits are set if the table has 64-bit hashes.
+         */
+        ResourcePathHash GetHash(size_t a_FileIndex) const;
+
+        /**
+         * @return True if the file at a_FileIndex has a_ResourcePathHash as its hash, comparing as many bits as the table stores
+         */
+        bool HasHash(size_t a_FileIndex, ResourcePathHash const& a_ResourcePathHash) const;
+
+        /**
+         * @return True if the hash of the file before a_FileIndex is smaller than the hash of the file at a_FileIndex
+         */
+        bool IsSortedAfterPrevious(size_t a_FileIndex) const;
+
+        /**
+         * @return Info on a file. Its hash is set as described for GetHash().
+         */
+        Archive::FileInfo GetFileInfo(size_t a_FileIndex) const;
+
+    private:
+        /** The table's data, in uint64_t units so every array is 8-byte aligned */
+        std::vector<uint64_t> m_Data;
+        size_t m_FileCount = 0;
+        uint8_t m_Flags = 0;
+
+        // Arrays in m_Data. Only one of the hash arrays and one of every pair of offset and size arrays is set, depending on m_Flags.
+        ResourcePathHash const* m_Hashes = nullptr;
+        uint64_t const* m_ShortHashes = nullptr;
+        uint64_t const* m_Offsets = nullptr;
+        uint32_t const* m_ShortOffsets = nullptr;
+        uint64_t const* m_Sizes = nullptr;
+        uint32_t const* m_ShortSizes = nullptr;
+        uint64_t const* m_StoredSizes = nullptr;
+        uint32_t const* m_ShortStoredSizes = nullptr;
+        uint32_t const* m_Checksums = nullptr;
+        Compression const* m_Compressions = nullptr;
+    };
+}
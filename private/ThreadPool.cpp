@@ -0,0 +1,113 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+using namespace hako;
+
+ThreadPool::ThreadPool(size_t a_ThreadCount)
+    : m_State(std::make_shared<State>())
+{
+    a_ThreadCount = std::max<size_t>(a_ThreadCount, 1);
+
+    m_Threads.reserve(a_ThreadCount);
+    for (size_t i = 0; i < a_ThreadCount; ++i)
+    {
+        m_Threads.emplace_back(&ThreadPool::WorkerLoop, m_State);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    std::thread::id const callingThread = std::this_thread::get_id();
+
+    {
+        std::unique_lock<std::mutex> lock(m_State->m_Mutex);
+        m_State->m_ShuttingDown = true;
+
+        if (IsWorkerThread())
+        {
+            // The pool is destroyed from one of its own jobs, which can't wait for itself. Run the remaining jobs here,
+            // so none of them runs after the pool's owner is gone, even if no other worker thread is free.
+            while (!m_State->m_Jobs.empty())
+            {
+                Job job = std::move(m_State->m_Jobs.front());
+                m_State->m_Jobs.pop_front();
+
+                lock.unlock();
+                job();
+                lock.lock();
+            }
+        }
+    }
+
+    m_State->m_JobQueued.notify_all();
+
+    for (std::thread& thread : m_Threads)
+    {
+        if (thread.get_id() == callingThread)
+        {
+            // Exits once the job that destroyed the pool returns, as the pool is shutting down and has no jobs left
+            thread.detach();
+        }
+        else
+        {
+            thread.join();
+        }
+    }
+}
+
+void ThreadPool::Enqueue(Job a_Job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_State->m_Mutex);
+        m_State->m_Jobs.push_back(std::move(a_Job));
+    }
+
+    m_State->m_JobQueued.notify_one();
+}
+
+void ThreadPool::WaitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(m_State->m_Mutex);
+    m_State->m_Idle.wait(lock, [this]() { return m_State->m_Jobs.empty() && m_State->m_RunningJobCount == 0; });
+}
+
+bool ThreadPool::IsWorkerThread() const
+{
+    std::thread::id const callingThread = std::this_thread::get_id();
+    return std::any_of(m_Threads.begin(), m_Threads.end(), [callingThread](std::thread const& a_Thread)
+        {
+            return a_Thread.get_id() == callingThread;
+        }
+    );
+}
+
+void ThreadPool::WorkerLoop(std::shared_ptr<State> a_State)
+{
+    std::unique_lock<std::mutex> lock(a_State->m_Mutex);
+
+    while (true)
+    {
+        a_State->m_JobQueued.wait(lock, [&a_State]() { return !a_State->m_Jobs.empty() || a_State->m_ShuttingDown; });
+
+        if (a_State->m_Jobs.empty())
+        {
+            // Shutting down, and all remaining jobs have been picked up
+            return;
+        }
+
+        Job job = std::move(a_State->m_Jobs.front());
+        a_State->m_Jobs.pop_front();
+        ++a_State->m_RunningJobCount;
+
+        lock.unlock();
+        job();
+        lock.lock();
+
+        --a_State->m_RunningJobCount;
+        if (a_State->m_Jobs.empty() && a_State->m_RunningJobCount == 0)
+        {
+            a_State->m_Idle.notify_all();
+        }
+    }
+}
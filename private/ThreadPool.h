@@ -0,0 +1,87 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hako
+{
+    /**
+     * Fixed-size pool of worker threads that execute jobs in the order they were enqueued
+     */
+    class ThreadPool final
+    {
+    public:
+        using Job = std::function<void()>;
+
+    public:
+        /**
+         * @param a_ThreadCount The number of worker threads to start. At least one thread is always started.
+         */
+        explicit ThreadPool(size_t a_ThreadCount);
+        /**
+         * Finishes all jobs that are still queued before joining the worker threads.
+         * If the pool is destroyed from one of its own jobs, the calling thread runs the remaining jobs itself and is detached instead of joined, and exits once its job returns.
+         */
+        ~ThreadPool();
+
+        ThreadPool(ThreadPool&) = delete;
+        ThreadPool(ThreadPool const&) = delete;
+        ThreadPool& operator=(ThreadPool const&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+
+        /**
+         * Queue a job to be executed on one of the worker threads
+         * @param a_Job The job to execute
+         */
+        void Enqueue(Job a_Job);
+
+        /**
+         * Block until all queued jobs have finished executing
+         */
+        void WaitUntilIdle();
+
+        /**
+         * @return The number of worker threads in the pool
+         */
+        size_t GetThreadCount() const
+        {
+            return m_Threads.size();
+        }
+
+        /**
+         * @return True if the calling thread is one of the pool's worker threads
+         */
+        bool IsWorkerThread() const;
+
+    private:
+        /**
+         * State shared with the worker threads, which outlives the pool if it is destroyed from one of its own jobs
+         */
+        struct State
+        {
+            std::deque<Job> m_Jobs;
+
+            std::mutex m_Mutex;
+            /** Signalled when a job is queued or the pool shuts down */
+            std::condition_variable m_JobQueued;
+            /** Signalled when the last running job finishes and the queue is empty */
+            std::condition_variable m_Idle;
+
+            /** Number of jobs that are currently being executed */
+            size_t m_RunningJobCount = 0;
+            bool m_ShuttingDown = false;
+        };
+
+        static void WorkerLoop(std::shared_ptr<State> a_State);
+
+    private:
+        std::shared_ptr<State> m_State;
+        std::vector<std::thread> m_Threads;
+    };
+}
@@ -0,0 +1,128 @@
+#include "ArchiveFileStream.h"
+
+#include "Compression.h"
+#include "HakoLog.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace hako;
+
+ArchiveFileStream::ArchiveFileStream(Archive const& a_Archive, ResourcePathHash const& a_ResourcePathHash)
+    : m_Archive(&a_Archive)
+{
+    a_Archive.RecordAccess(a_ResourcePathHash);
+
+#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+    m_FileOutsideArchive = a_Archive.OpenFileOutsideArchive(a_ResourcePathHash);
+    if (m_FileOutsideArchive != nullptr)
+    {
+        m_Size = m_FileOutsideArchive->GetFileSize();
+        m_IsValid = true;
+        return;
+    }
+#endif
+
+    std::optional<Archive::FileInfo> const fi = a_Archive.GetFileInfo(a_ResourcePathHash);
+    if (!fi)
+    {
+        hako::Log("Unable to find file with hash \"%s\" in archive.\n", a_ResourcePathHash.ToString().c_str());
+        return;
+    }
+
+    m_FileInfo = *fi;
+    m_Size = fi->m_Size;
+
+    if (fi->m_Compression != Compression::None && a_Archive.m_MappedArchive.empty())
+    {
+        // Keep the chunk table around, so reads don't have to fetch it every time
+        if (!a_Archive.ReadChunkTable(m_FileInfo, m_ChunkTable))
+        {
+            return;
+        }
+    }
+
+    m_IsValid = true;
+}
+
+ArchiveFileStream::~ArchiveFileStream() = default;
+
+size_t ArchiveFileStream::Read(char* a_OutBuffer, size_t a_NumBytes)
+{
+    size_t const bytesRead = ReadAtPosition(a_OutBuffer, a_NumBytes);
+    m_Position += bytesRead;
+
+    return bytesRead;
+}
+
+bool ArchiveFileStream::Seek(size_t a_Position)
+{
+    if (a_Position > m_Size)
+    {
+        return false;
+    }
+
+    m_Position = a_Position;
+    return true;
+}
+
+size_t ArchiveFileStream::ReadAtPosition(char* a_OutBuffer, size_t a_NumBytes)
+{
+    if (!m_IsValid || m_Position >= m_Size)
+    {
+        return 0;
+    }
+
+    a_NumBytes = std::min(a_NumBytes, m_Size - m_Position);
+
+    if (m_FileOutsideArchive != nullptr)
+    {
+        return m_FileOutsideArchive->Read(a_NumBytes, m_Position, a_OutBuffer) ? a_NumBytes : 0;
+    }
+
+    char const* const chunkTable = m_ChunkTable.empty() ? nullptr : m_ChunkTable.data();
+
+    if (m_FileInfo.m_Compression == Compression::None)
+    {
+        return m_Archive->LoadFileRange(m_FileInfo, m_Position, a_NumBytes, a_OutBuffer) ? a_NumBytes : 0;
+    }
+
+    size_t bytesRead = 0;
+    while (bytesRead < a_NumBytes)
+    {
+        size_t const position = m_Position + bytesRead;
+        size_t const chunkIndex = position / CompressionChunkSize;
+        size_t const chunkOffset = chunkIndex * CompressionChunkSize;
+        size_t const chunkSize = std::min(CompressionChunkSize, m_Size - chunkOffset);
+        size_t const bytesFromChunk = std::min(a_NumBytes - bytesRead, chunkOffset + chunkSize - position);
+
+        if (bytesFromChunk == chunkSize)
+        {
+            // Whole chunk requested, so decompress it straight into the output
+            if (!m_Archive->LoadFileRange(m_FileInfo, position, bytesFromChunk, a_OutBuffer + bytesRead, chunkTable))
+            {
+                break;
+            }
+        }
+        else
+        {
+            if (m_ChunkDataIndex != chunkIndex)
+            {
+                m_ChunkData.resize(chunkSize);
+                if (!m_Archive->LoadFileRange(m_FileInfo, chunkOffset, chunkSize, m_ChunkData.data(), chunkTable))
+                {
+                    m_ChunkDataIndex = static_cast<size_t>(-1);
+                    break;
+                }
+
+                m_ChunkDataIndex = chunkIndex;
+            }
+
+            memcpy(a_OutBuffer + bytesRead, m_ChunkData.data() + (position - chunkOffset), bytesFromChunk);
+        }
+
+        bytesRead += bytesFromChunk;
+    }
+
+    return bytesRead;
+}
@@ -0,0 +1,259 @@
+#include "ArchiveSet.h"
+
+#include "ArchiveStatistics.h"
+#include "HakoLog.h"
+#include "TableOfContents.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace hako;
+
+ArchiveSet::ArchiveSet()
+    : m_Index(std::make_shared<Index const>())
+{ }
+
+ArchiveSet::~ArchiveSet() = default;
+
+bool ArchiveSet::Mount(std::shared_ptr<Archive const> a_Archive, int32_t a_Priority)
+{
+    if (a_Archive == nullptr || !a_Archive->IsOpen())
+    {
+        hako::Log("Unable to mount an archive that is not open.\n");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_MountMutex);
+
+    std::shared_ptr<Index const> const currentIndex = GetIndex();
+    std::vector<MountedArchive> const& mounts = currentIndex->m_Mounts;
+    bool const alreadyMounted = std::any_of(mounts.begin(), mounts.end(), [&a_Archive](MountedArchive const& a_Mount)
+        {
+            return a_Mount.m_Archive == a_Archive;
+        }
+    );
+
+    if (alreadyMounted)
+    {
+        return false;
+    }
+
+    // Readers may still use the current index, so the new archive's files are added to a copy of it. Copying takes time linear in the number of indexed files,
+    // but only the new archive's table of contents is read and merged in.
+    auto index = std::make_shared<Index>(*currentIndex);
+
+    // Insert after all archives with the same priority, so the archive that is mounted last wins ties
+    auto const insertPosition = std::upper_bound(index->m_Mounts.begin(), index->m_Mounts.end(), a_Priority, [](int32_t a_Lhs, MountedArchive const& a_Rhs)
+        {
+            return a_Lhs < a_Rhs.m_Priority;
+        }
+    );
+    MountedArchive const& mount = *index->m_Mounts.insert(insertPosition, { std::move(a_Archive), a_Priority });
+
+    index->m_Files.reserve(index->m_Files.size() + mount.m_Archive->m_TableOfContents->GetFileCount());
+    AddToIndex(*index, mount);
+
+    PublishIndex(std::move(index));
+    return true;
+}
+
+bool ArchiveSet::Unmount(Archive const& a_Archive)
+{
+    std::lock_guard<std::mutex> lock(m_MountMutex);
+
+    std::vector<MountedArchive> mounts = GetIndex()->m_Mounts;
+    auto const it = std::find_if(mounts.begin(), mounts.end(), [&a_Archive](MountedArchive const& a_Mount)
+        {
+            return a_Mount.m_Archive.get() == &a_Archive;
+        }
+    );
+
+    if (it == mounts.end())
+    {
+        return false;
+    }
+
+    mounts.erase(it);
+
+    PublishIndex(BuildIndex(std::move(mounts)));
+    return true;
+}
+
+void ArchiveSet::UnmountAll()
+{
+    std::lock_guard<std::mutex> lock(m_MountMutex);
+    PublishIndex(std::make_shared<Index>());
+}
+
+size_t ArchiveSet::GetMountedArchiveCount() const
+{
+    return GetIndex()->m_Mounts.size();
+}
+
+bool ArchiveSet::HasFile(ResourcePathHash const& a_ResourcePathHash) const
+{
+    std::shared_ptr<Index const> const index = GetIndex();
+    return FindFile(*index, a_ResourcePathHash).has_value();
+}
+
+size_t ArchiveSet::GetFileSize(ResourcePathHash const& a_ResourcePathHash) const
+{
+    std::shared_ptr<Index const> const index = GetIndex();
+    std::optional<FoundFile> const entry = FindFile(*index, a_ResourcePathHash);
+    if (!entry)
+    {
+        return 0;
+    }
+
+#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+    if (std::unique_ptr<IFile> const file = entry->m_Archive->OpenFileOutsideArchive(a_ResourcePathHash))
+    {
+        return file->GetFileSize();
+    }
+#endif
+
+    return entry->m_FileInfo.m_Size;
+}
+
+bool ArchiveSet::ReadFile(char const* a_FileName, std::vector<char>& a_OutData) const
+{
+    ResourcePathHash hash;
+    GetResourcePathHash(a_FileName, hash);
+
+    return ReadFile(hash, a_OutData);
+}
+
+bool ArchiveSet::ReadFile(ResourcePathHash const& a_ResourcePathHash, std::vector<char>& a_OutData) const
+{
+    std::shared_ptr<Index const> const index = GetIndex();
+    std::optional<FoundFile> const entry = FindFile(*index, a_ResourcePathHash);
+    if (!entry)
+    {
+        hako::Log("Unable to find file with hash \"%s\" in any mounted archive.\n", a_ResourcePathHash.ToString().c_str());
+        return false;
+    }
+
+    return entry->m_Archive->ReadFile(a_ResourcePathHash, &entry->m_FileInfo, a_OutData);
+}
+
+bool ArchiveSet::ReadFile(ResourcePathHash const& a_ResourcePathHash, char* a_OutBuffer, size_t a_BufferSize) const
+{
+    std::shared_ptr<Index const> const index = GetIndex();
+    std::optional<FoundFile> const entry = FindFile(*index, a_ResourcePathHash);
+    if (!entry)
+    {
+        hako::Log("Unable to find file with hash \"%s\" in any mounted archive.\n", a_ResourcePathHash.ToString().c_str());
+        return false;
+    }
+
+    return entry->m_Archive->ReadFile(a_ResourcePathHash, &entry->m_FileInfo, a_OutBuffer, a_BufferSize);
+}
+
+bool ArchiveSet::ReadRange(ResourcePathHash const& a_ResourcePathHash, size_t a_Offset, size_t a_NumBytes, char* a_OutBuffer) const
+{
+    std::shared_ptr<Index const> const index = GetIndex();
+    std::optional<FoundFile> const entry = FindFile(*index, a_ResourcePathHash);
+    if (!entry)
+    {
+        hako::Log("Unable to find file with hash \"%s\" in any mounted archive.\n", a_ResourcePathHash.ToString().c_str());
+        return false;
+    }
+
+    return entry->m_Archive->ReadRange(a_ResourcePathHash, &entry->m_FileInfo, a_Offset, a_NumBytes, a_OutBuffer);
+}
+
+Span<char const> ArchiveSet::ReadFileView(ResourcePathHash const& a_ResourcePathHash) const
+{
+    std::shared_ptr<Index const> const index = GetIndex();
+    std::optional<FoundFile> const entry = FindFile(*index, a_ResourcePathHash);
+    if (!entry)
+    {
+        return {};
+    }
+
+    return entry->m_Archive->ReadFileView(a_ResourcePathHash, &entry->m_FileInfo);
+}
+
+std::shared_ptr<ArchiveSet::Index> ArchiveSet::BuildIndex(std::vector<MountedArchive> a_Mounts)
+{
+    auto index = std::make_shared<Index>();
+    index->m_Mounts = std::move(a_Mounts);
+
+    size_t fileCount = 0;
+    for (MountedArchive const& mount : index->m_Mounts)
+    {
+        fileCount += mount.m_Archive->m_TableOfContents->GetFileCount();
+    }
+    index->m_Files.reserve(fileCount);
+
+    for (MountedArchive const& mount : index->m_Mounts)
+    {
+        AddToIndex(*index, mount);
+    }
+
+    return index;
+}
+
+void ArchiveSet::AddToIndex(Index& a_Index, MountedArchive const& a_Mount)
+{
+    TableOfContents const& tableOfContents = *a_Mount.m_Archive->m_TableOfContents;
+    for (size_t fileIndex = 0; fileIndex < tableOfContents.GetFileCount(); ++fileIndex)
+    {
+        auto const [it, inserted] = a_Index.m_Files.try_emplace(tableOfContents.GetHash(fileIndex).hash64[0], IndexEntry{ a_Mount.m_Archive.get(), fileIndex, a_Mount.m_Priority });
+
+        // The archive that is mounted last wins ties, which is the one being added
+        if (!inserted && it->second.m_Priority <= a_Mount.m_Priority)
+        {
+            it->second = { a_Mount.m_Archive.get(), fileIndex, a_Mount.m_Priority };
+        }
+    }
+}
+
+void ArchiveSet::PublishIndex(std::shared_ptr<Index const> a_Index)
+{
+    std::atomic_store(&m_Index, std::move(a_Index));
+}
+
+std::shared_ptr<ArchiveSet::Index const> ArchiveSet::GetIndex() const
+{
+    return std::atomic_load(&m_Index);
+}
+
+std::optional<ArchiveSet::FoundFile> ArchiveSet::FindFile(Index const& a_Index, ResourcePathHash const& a_ResourcePathHash)
+{
+    // The lookup is recorded in the statistics of the archive the file is found in, as files that aren't found don't belong to any archive
+    ArchiveStatistics::Timer const timer = ArchiveStatistics::StartLookupTimer();
+
+    auto const it = a_Index.m_Files.find(a_ResourcePathHash.hash64[0]);
+    if (it == a_Index.m_Files.end())
+    {
+        return std::nullopt;
+    }
+
+    IndexEntry const& entry = it->second;
+    TableOfContents const& tableOfContents = *entry.m_Archive->m_TableOfContents;
+    if (tableOfContents.HasHash(entry.m_FileIndex, a_ResourcePathHash))
+    {
+        Archive::FileInfo fi = tableOfContents.GetFileInfo(entry.m_FileIndex);
+        fi.m_ResourcePathHash = a_ResourcePathHash;
+        entry.m_Archive->m_Statistics->RecordLookup(true, timer);
+        return FoundFile{ entry.m_Archive, fi };
+    }
+
+    // Another file shares the first 64 bits of the hash. This is rare enough to fall back to searching every archive, from highest to lowest priority.
+    for (auto mount = a_Index.m_Mounts.rbegin(); mount != a_Index.m_Mounts.rend(); ++mount)
+    {
+        if (mount->m_Archive->m_TableOfContents->GetFileCount() == 0)
+        {
+            continue;
+        }
+
+        if (std::optional<Archive::FileInfo> const fi = mount->m_Archive->FindFileInfo(a_ResourcePathHash))
+        {
+            mount->m_Archive->m_Statistics->RecordLookup(true, timer);
+            return FoundFile{ mount->m_Archive.get(), *fi };
+        }
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,171 @@
+#include "DirectFile.h"
+
+#if defined(HAKO_DIRECT_FILE_IO)
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace hako;
+
+namespace
+{
+	/** Size of the bounce buffer used for unaligned reads */
+	constexpr size_t BounceBufferSize = 1024 * 1024;
+
+	struct AlignedFree
+	{
+		void operator()(char* a_Buffer) const
+		{
+			free(a_Buffer);
+		}
+	};
+
+	bool IsAligned(size_t a_Value)
+	{
+		return a_Value % DirectFile::DirectIOAlignment == 0;
+	}
+
+	/**
+	 * Get the calling thread's bounce buffer, which is allocated on first use and reused by all of the thread's unaligned reads
+	 * @return A buffer of BounceBufferSize bytes aligned to DirectIOAlignment, or a nullptr if it could not be allocated
+	 */
+	char* GetBounceBuffer()
+	{
+		thread_local std::unique_ptr<char, AlignedFree> bounceBuffer{ static_cast<char*>(aligned_alloc(DirectFile::DirectIOAlignment, BounceBufferSize)) };
+		return bounceBuffer.get();
+	}
+}
+
+DirectFile::~DirectFile()
+{
+	CloseFile();
+}
+
+bool DirectFile::Open(std::string const& a_FilePath)
+{
+	CloseFile();
+	m_FileDescriptor = open(a_FilePath.c_str(), O_RDONLY | O_DIRECT | O_CLOEXEC);
+
+	return m_FileDescriptor >= 0;
+}
+
+bool DirectFile::Read(size_t a_NumBytes, size_t a_Offset, std::vector<char>& a_Buffer)
+{
+	assert(a_Buffer.size() >= a_NumBytes);
+
+	return Read(a_NumBytes, a_Offset, a_Buffer.data());
+}
+
+bool DirectFile::Read(size_t a_NumBytes, size_t a_Offset, char* a_Buffer)
+{
+	assert(m_FileDescriptor >= 0);
+
+	char* bounceBuffer = nullptr;
+
+	size_t bytesRead = 0;
+	while (bytesRead < a_NumBytes)
+	{
+		size_t const position = a_Offset + bytesRead;
+		size_t const remainingBytes = a_NumBytes - bytesRead;
+		char* const destination = a_Buffer + bytesRead;
+
+		if (IsAligned(position) && IsAligned(reinterpret_cast<uintptr_t>(destination)) && remainingBytes >= DirectIOAlignment)
+		{
+			// Read whole blocks straight into the caller's buffer
+			ssize_t const result = pread(m_FileDescriptor, destination, remainingBytes - remainingBytes % DirectIOAlignment, static_cast<off_t>(position));
+			if (result < 0 && errno == EINTR)
+			{
+				continue;
+			}
+
+			if (result <= 0)
+			{
+				return false;
+			}
+
+			bytesRead += static_cast<size_t>(result);
+			continue;
+		}
+
+		if (bounceBuffer == nullptr)
+		{
+			bounceBuffer = GetBounceBuffer();
+			if (bounceBuffer == nullptr)
+			{
+				return false;
+			}
+		}
+
+		// Read the blocks around the requested range, and copy the requested part out of them
+		size_t const blockStart = position - position % DirectIOAlignment;
+		size_t const leadingBytes = position - blockStart;
+		size_t const blockBytes = std::min(BounceBufferSize, (leadingBytes + remainingBytes + DirectIOAlignment - 1) / DirectIOAlignment * DirectIOAlignment);
+
+		ssize_t const result = pread(m_FileDescriptor, bounceBuffer, blockBytes, static_cast<off_t>(blockStart));
+		if (result < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+		// Reads may come up short at the end of the file
+		if (result <= static_cast<ssize_t>(leadingBytes))
+		{
+			return false;
+		}
+
+		size_t const copiedBytes = std::min(static_cast<size_t>(result) - leadingBytes, remainingBytes);
+		memcpy(destination, bounceBuffer + leadingBytes, copiedBytes);
+		bytesRead += copiedBytes;
+	}
+
+	return true;
+}
+
+bool DirectFile::Write(size_t, std::vector<char> const&)
+{
+	// Direct files are read-only
+	return false;
+}
+
+size_t DirectFile::GetFileSize()
+{
+	assert(m_FileDescriptor >= 0);
+
+	struct stat fileStat{};
+	if (fstat(m_FileDescriptor, &fileStat) != 0)
+	{
+		return 0;
+	}
+
+	return static_cast<size_t>(fileStat.st_size);
+}
+
+bool DirectFile::SupportsConcurrentReads() const
+{
+	// pread() doesn't touch the file position, and every thread has its own bounce buffer
+	return true;
+}
+
+bool DirectFile::Prefetch(size_t, size_t)
+{
+	// Reads bypass the page cache, so there is nothing to warm up
+	return true;
+}
+
+void DirectFile::CloseFile()
+{
+	if (m_FileDescriptor >= 0)
+	{
+		close(m_FileDescriptor);
+		m_FileDescriptor = -1;
+	}
+}
+#endif
@@ -1,13 +1,26 @@
 #include "Hako.h"
 #include "HakoFile.h"
+#include "MemoryFile.h"
 
+#include "AccessTrace.h"
+#include "ArchiveStatistics.h"
+#include "Checksum.h"
+#include "Compression.h"
+#include "ContentCache.h"
 #include "HakoLog.h"
-#include "MurmurHash3.h"
+#include "IntermediateOverlay.h"
 #include "SerializerList.h"
+#include "TableOfContents.h"
+#include "ThreadPool.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cinttypes>
+#include <condition_variable>
 #include <filesystem>
+#include <functional>
+#include <thread>
+#include <unordered_map>
 
 #define HAKO_ASSERT(x, ...) do { bool const result = (x); if(!result) { hako::Log(__VA_ARGS__); assert(result); } } while(false)
 
@@ -90,15 +103,79 @@ namespace
 
         return GetIntermediateFilePath(a_TargetPlatform, resourcePathHash);
     }
+
+    /**
+     * Check a file's data as stored in the archive against the file's checksum
+     * @param a_FileInfo The file info for the file
+     * @param a_StoredData The file's data as stored in the archive (a_FileInfo.m_StoredSize bytes)
+     * @return True if the data matches the checksum
+     */
+    bool IsChecksumValid(hako::Archive::FileInfo const& a_FileInfo, char const* a_StoredData)
+    {
+        if (hako::ComputeCrc32c(a_StoredData, a_FileInfo.m_StoredSize) != a_FileInfo.m_Checksum)
+        {
+            hako::Log("File with hash \"%s\" does not match its checksum. The archive might be corrupted.\n", a_FileInfo.m_ResourcePathHash.ToString().c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Format a file's hash for messages
+     * @param a_Hash The hash of the file
+     * @param a_IsTruncated True if only the first 64 bits of the hash are known, e.g. because it was read from a table of contents with 64-bit hashes
+     * @return The hash as hexadecimal digits, with only the first 64 bits if the hash is truncated
+     */
+    std::string GetHashString(hako::ResourcePathHash const& a_Hash, bool a_IsTruncated)
+    {
+        if (!a_IsTruncated)
+        {
+            return a_Hash.ToString();
+        }
+
+        char buffer[17];
+        snprintf(buffer, sizeof(buffer), "%016" PRIX64, a_Hash.hash64[0]);
+        return buffer;
+    }
+
+    /**
+     * Turn a file's data as stored in the archive into the file's content
+     * @param a_FileInfo The file info for the file
+     * @param a_StoredData The file's data as stored in the archive (a_FileInfo.m_StoredSize bytes)
+     * @param a_OutBuffer The buffer to output the file's content into (a_FileInfo.m_Size bytes)
+     * @return True if the file's content was successfully decoded
+     */
+    bool DecodeFileContent(hako::Archive::FileInfo const& a_FileInfo, char const* a_StoredData, char* a_OutBuffer)
+    {
+        if (a_FileInfo.m_Compression == hako::Compression::None)
+        {
+            memcpy(a_OutBuffer, a_StoredData, a_FileInfo.m_Size);
+            return true;
+        }
+
+        size_t const chunkTableSize = hako::GetCompressionChunkTableSize(a_FileInfo.m_Size);
+        if (!hako::DecompressChunked(a_StoredData, a_FileInfo.m_Size, a_StoredData + chunkTableSize, 0, a_FileInfo.m_StoredSize - chunkTableSize, 0, a_FileInfo.m_Size, a_OutBuffer))
+        {
+            hako::Log("Unable to decompress file with hash \"%s\". The archive might be corrupted.\n", a_FileInfo.m_ResourcePathHash.ToString().c_str());
+            return false;
+        }
+
+        return true;
+    }
 }
 
 namespace hako
 {
-    constexpr size_t WriteChunkSize = 10 * 1024; // 10 MiB
-    constexpr uint8_t ArchiveVersion = 2;
+    constexpr size_t WriteChunkSize = 10 * 1024 * 1024; // 10 MiB
+    constexpr size_t MaxIOThreadCount = 4;
+    /** Files that are at most this many bytes apart are read with a single read when reading multiple files at once */
+    constexpr size_t MaxCoalescedReadGap = 64 * 1024;
+    /** Upper bound for the size of a single coalesced read */
+    constexpr size_t MaxCoalescedReadSize = 16 * 1024 * 1024;
+    constexpr uint8_t ArchiveVersion = 7;
     constexpr char ArchiveMagic[] = { 'H', 'A', 'K', 'O' };
     constexpr uint8_t MagicLength = sizeof(ArchiveMagic);
-    constexpr uint32_t Murmur3Seed = 0x48'41'4B'4F;
 
     struct ArchiveHeader
     {
@@ -110,9 +187,46 @@ namespace hako
         char m_Magic[MagicLength]{};
         uint8_t m_ArchiveVersion = ArchiveVersion;
         uint8_t m_HeaderSize = sizeof(ArchiveHeader);
-        char m_Padding[2] = {};
+        /** How the table of contents is stored (see TableOfContents::Flag64BitHashes and TableOfContents::Flag32BitOffsets) */
+        uint8_t m_TableOfContentsFlags = 0;
+        char m_Padding[1] = {};
         uint32_t m_FileCount = 0;
+        /** Number of leading hash bits that select a lookup index bucket */
+        uint8_t m_LookupIndexBucketBits = 0;
+        char m_Padding2[3] = {};
+        /** Offset of the lookup index from the start of the archive, or 0 if the archive has no lookup index */
+        uint64_t m_LookupIndexOffset = 0;
+        /** Number of entries in the load group table */
+        uint32_t m_LoadGroupCount = 0;
+        char m_Padding3[4] = {};
+        /** Offset of the load group table from the start of the archive, or 0 if the archive has no load groups */
+        uint64_t m_LoadGroupTableOffset = 0;
     };
+    static_assert(sizeof(ArchiveHeader) == 40 && "ArchiveHeader size changed");
+
+    /**
+     * The lookup index maps the leading bits of a hash to the range of files in the (sorted) table of contents that start with those bits.
+     * It stores the index of the first file of each bucket, followed by the file count, so bucket b holds files [index[b], index[b + 1]).
+     * There are at least as many buckets as files, so a lookup usually only has to compare a single file's hash.
+     */
+    using LookupIndexEntry = uint32_t;
+    constexpr uint8_t MaxLookupIndexBucketBits = 24;
+
+    uint8_t GetLookupIndexBucketBits(size_t a_FileCount)
+    {
+        uint8_t bucketBits = 0;
+        while (bucketBits < MaxLookupIndexBucketBits && (size_t{ 1 } << bucketBits) < a_FileCount)
+        {
+            ++bucketBits;
+        }
+
+        return bucketBits;
+    }
+
+    size_t GetLookupIndexBucket(ResourcePathHash const& a_Hash, uint8_t a_BucketBits)
+    {
+        return a_BucketBits == 0 ? 0 : static_cast<size_t>(a_Hash.hash64[0] >> (64 - a_BucketBits));
+    }
 
     /** The factory function to use for file IO */
     FileFactorySignature s_FileFactory = hako::HakoFileFactory;
@@ -126,7 +240,8 @@ namespace hako
 
     void ResourcePathHash::ToString(char* a_OutBuffer) const
     {
-        snprintf(a_OutBuffer, MaxResourcePathHashLength, "%zX%zX", hash64[0], hash64[1]);
+        // Zero-pad both halves so FromString can split the string in the middle
+        snprintf(a_OutBuffer, MaxResourcePathHashLength, "%016" PRIX64 "%016" PRIX64, hash64[0], hash64[1]);
     }
 
     bool ResourcePathHash::operator<(ResourcePathHash const& a_Rhs) const
@@ -163,7 +278,7 @@ namespace hako
         ResourcePathHash hash;
         for (auto& outHash : hash.hash64)
         {
-            strncpy_s(partialHash.data(), partialHash.length(), path + offset, PartialHashLength);
+            strncpy(partialHash.data(), path + offset, PartialHashLength);
             outHash = std::stoull(partialHash, nullptr, 16);
 
             offset += PartialHashLength;
@@ -184,42 +299,107 @@ namespace hako
     }
 
     /**
-     * Copy a file into the archive
+     * Picks the offset at which a file is written to the archive
+     * @param a_StoredSize The number of bytes the file takes up in the archive, or an empty optional if the file can't be read and its entry stays empty
+     * @return The offset to write the file at, or an empty optional if the file must not be written
+     */
+    using AssignOffsetFunction = std::function<std::optional<size_t>(std::optional<size_t> a_StoredSize)>;
+
+    /**
+     * Copy a file into the archive. Multiple files can be archived at the same time if the archive supports concurrent writes.
      * @param a_Archive The archive to write to
      * @param a_FilePath The path of the file to archive
-     * @param a_FileInfo File info for the file that should be copied into the archive
+     * @param a_FileInfo File info for the file that should be copied into the archive. Receives the file's offset, size and compression.
+     * @param a_Compress Whether to try to compress the file
+     * @param a_AssignOffset Called exactly once before anything is written, even if the file can't be read
      * @return The number of bytes written
      */
-    size_t ArchiveFile(IFile* a_Archive, char const* a_FilePath, Archive::FileInfo const& a_FileInfo)
+    size_t ArchiveFile(IFile* a_Archive, char const* a_FilePath, Archive::FileInfo& a_FileInfo, bool a_Compress, AssignOffsetFunction const& a_AssignOffset)
     {
         HAKO_ASSERT(a_FilePath && a_FilePath[0] != 0, "No file path provided!");
 
+        // Files that can't be archived keep an empty entry, so a_FileInfo is only filled in once the whole file was written
+        a_FileInfo.m_Compression = Compression::None;
+        a_FileInfo.m_Offset = 0;
+        a_FileInfo.m_Size = 0;
+        a_FileInfo.m_StoredSize = 0;
+        a_FileInfo.m_Checksum = 0;
+
         auto const intermediateFile = s_FileFactory(a_FilePath, FileOpenMode::Read);
         if (!intermediateFile)
         {
+            hako::Log("Unable to archive file %s\n", a_FilePath);
+            a_AssignOffset(std::nullopt);
             return 0;
         }
 
         auto const fileSize = intermediateFile->GetFileSize();
+
+        if (a_Compress && fileSize > 0)
+        {
+            // Chunks are compressed independently, but we need the whole file to know whether compressing it is worth it
+            std::vector<char> data(fileSize);
+            if (!intermediateFile->Read(fileSize, 0, data))
+            {
+                hako::Log("Unable to archive file %s\n", a_FilePath);
+                a_AssignOffset(std::nullopt);
+                return 0;
+            }
+
+            std::vector<char> compressedData{};
+            bool const compressed = CompressChunked(data.data(), data.size(), compressedData);
+            std::vector<char> const& storedData = compressed ? compressedData : data;
+
+            std::optional<size_t> const offset = a_AssignOffset(storedData.size());
+            if (!offset || !a_Archive->Write(*offset, storedData))
+            {
+                hako::Log("Unable to archive file %s\n", a_FilePath);
+                return 0;
+            }
+
+            a_FileInfo.m_Offset = *offset;
+
+            a_FileInfo.m_Compression = compressed ? Compression::LZ : Compression::None;
+            a_FileInfo.m_Size = fileSize;
+            a_FileInfo.m_StoredSize = storedData.size();
+            a_FileInfo.m_Checksum = ComputeCrc32c(storedData.data(), storedData.size());
+            return storedData.size();
+        }
+
+        std::optional<size_t> const offset = a_AssignOffset(fileSize);
+        if (!offset)
+        {
+            hako::Log("Unable to archive file %s\n", a_FilePath);
+            return 0;
+        }
+
+        // Let the archive copy the file without passing it through user space if it can. The checksum still has to be computed from the file's content.
+        bool const copied = fileSize > 0 && a_Archive->CopyFrom(*intermediateFile, fileSize, 0, *offset);
+
+        // The buffer is only allocated once, as growing a vector zero-fills it. Only the last chunk shrinks it.
         size_t bytesRead = 0;
-        std::vector<char> data{};
+        uint32_t checksum = 0;
+        std::vector<char> data(std::min(fileSize, WriteChunkSize));
 
         while (bytesRead < fileSize)
         {
             size_t const bytesToRead = std::min(fileSize - bytesRead, WriteChunkSize);
-            data.clear();
             data.resize(bytesToRead);
 
-            if (!intermediateFile->Read(bytesToRead, bytesRead, data))
+            if (!intermediateFile->Read(bytesToRead, bytesRead, data.data()) || (!copied && !a_Archive->Write(*offset + bytesRead, data)))
             {
                 hako::Log("Unable to archive file %s\n", a_FilePath);
                 return 0;
             }
 
-            a_Archive->Write(a_FileInfo.m_Offset + bytesRead, data);
+            checksum = ComputeCrc32c(data.data(), bytesToRead, checksum);
             bytesRead += bytesToRead;
         }
 
+        a_FileInfo.m_Offset = *offset;
+        a_FileInfo.m_Checksum = checksum;
+        a_FileInfo.m_Size = bytesRead;
+        a_FileInfo.m_StoredSize = bytesRead;
         return bytesRead;
     }
 
@@ -255,7 +435,7 @@ namespace hako
         IntermediateDirectory = std::string(a_IntermediateDirectory);
     }
 
-    bool CreateArchive(Platform a_TargetPlatform, char const* const a_ArchiveName, bool a_OverwriteExistingFile)
+    bool CreateArchive(Platform a_TargetPlatform, char const* const a_ArchiveName, bool a_OverwriteExistingFile, ArchiveCreationSettings const& a_Settings)
     {
         HAKO_ASSERT(a_ArchiveName, "No archive path specified for archive creation\n");
 
@@ -266,20 +446,51 @@ namespace hako
             return false;
         }
 
+        size_t const entryAlignment = a_Settings.m_EntryAlignment;
+        if (entryAlignment == 0 || (entryAlignment & (entryAlignment - 1)) != 0)
+        {
+            hako::Log("Failed to create archive \"%s\" - entry alignment %zu is not a power of two.\n", a_ArchiveName, entryAlignment);
+            return false;
+        }
+
+        std::vector<ResourcePathHash> loadGroupNameHashes{};
+        loadGroupNameHashes.reserve(a_Settings.m_LoadGroups.size());
+        for (ArchiveLoadGroup const& group : a_Settings.m_LoadGroups)
+        {
+            if (group.m_Name.empty())
+            {
+                hako::Log("Failed to create archive \"%s\" - a load group has no name.\n", a_ArchiveName);
+                return false;
+            }
+
+            ResourcePathHash nameHash{};
+            GetResourcePathHash(group.m_Name.c_str(), nameHash);
+            if (std::find(loadGroupNameHashes.begin(), loadGroupNameHashes.end(), nameHash) != loadGroupNameHashes.end())
+            {
+                hako::Log("Failed to create archive \"%s\" - load group \"%s\" is defined more than once.\n", a_ArchiveName, group.m_Name.c_str());
+                return false;
+            }
+
+            loadGroupNameHashes.push_back(nameHash);
+        }
+
         std::unique_ptr<IFile> const archive = s_FileFactory(a_ArchiveName, FileOpenMode::WriteTruncate);
         HAKO_ASSERT(archive != nullptr, "Unable to open archive \"%s\" for writing!\n", a_ArchiveName);
 
         struct HashPathPair
         {
-            HashPathPair(std::filesystem::path const& a_FilePath)
+            HashPathPair(std::filesystem::path const& a_FilePath, size_t a_FileSize)
                 : m_FilePath(a_FilePath.generic_string())
             , m_ResourcePathHash(ResourcePathHash::FromString(a_FilePath.filename().generic_string().c_str()))
+            , m_FileSize(a_FileSize)
             { }
 
             // Full file path (with hashed file name)
             std::string m_FilePath{};
             // Hashed file name
             ResourcePathHash m_ResourcePathHash;
+            // Size of the file before it is compressed
+            size_t m_FileSize = 0;
         };
 
         std::vector<HashPathPair> filePaths;
@@ -290,19 +501,10 @@ namespace hako
         {
             if (dirEntry.is_regular_file())
             {
-                filePaths.emplace_back(dirEntry.path());
+                filePaths.emplace_back(dirEntry.path(), static_cast<size_t>(dirEntry.file_size()));
             }
         }
 
-        size_t archiveInfoBytesWritten = 0;
-
-        {
-            ArchiveHeader header;
-            header.m_FileCount = filePaths.size();
-            WriteToArchive(archive.get(), &header, sizeof(ArchiveHeader), archiveInfoBytesWritten);
-            archiveInfoBytesWritten += sizeof(ArchiveHeader);
-        }
-
         // Sort file hashes alphabetically
         std::sort(filePaths.begin(), filePaths.end(), [](HashPathPair const& a_Lhs, HashPathPair const& a_Rhs)
             {
@@ -310,23 +512,308 @@ namespace hako
             }
         );
 
-        size_t totalFileSize = 0;
+        std::unordered_map<ResourcePathHash, size_t> fileIndices{};
+        fileIndices.reserve(filePaths.size());
+        for (size_t fileIndex = 0; fileIndex < filePaths.size(); ++fileIndex)
+        {
+            fileIndices.emplace(filePaths[fileIndex].m_ResourcePathHash, fileIndex);
+        }
+
+        // Files are written in hash order, unless load groups or an access trace say in which order they are loaded
+        std::vector<size_t> fileLayoutOrder{};
+        fileLayoutOrder.reserve(filePaths.size());
+        std::vector<bool> isPlaced(filePaths.size(), false);
+
+        struct PlacedLoadGroup
+        {
+            ResourcePathHash m_NameHash{};
+            // Range of the group's files in fileLayoutOrder
+            size_t m_FirstLayoutIndex = 0;
+            size_t m_LayoutEnd = 0;
+        };
+
+        // Load groups come first, so every group's files are contiguous
+        std::vector<PlacedLoadGroup> placedLoadGroups{};
+        for (size_t groupIndex = 0; groupIndex < a_Settings.m_LoadGroups.size(); ++groupIndex)
+        {
+            ArchiveLoadGroup const& group = a_Settings.m_LoadGroups[groupIndex];
+
+            PlacedLoadGroup placedGroup{};
+            placedGroup.m_NameHash = loadGroupNameHashes[groupIndex];
+            placedGroup.m_FirstLayoutIndex = fileLayoutOrder.size();
+
+            for (std::string const& resourcePath : group.m_ResourcePaths)
+            {
+                ResourcePathHash hash{};
+                GetResourcePathHash(resourcePath.c_str(), hash);
+
+                auto const it = fileIndices.find(hash);
+                if (it == fileIndices.end())
+                {
+                    hako::Log("File \"%s\" of load group \"%s\" has not been serialized, so it can't be archived.\n", resourcePath.c_str(), group.m_Name.c_str());
+                    continue;
+                }
+
+                if (isPlaced[it->second])
+                {
+                    hako::Log("File \"%s\" is listed more than once in load groups. It stays in the first group it is listed in.\n", resourcePath.c_str());
+                    continue;
+                }
+
+                fileLayoutOrder.push_back(it->second);
+                isPlaced[it->second] = true;
+            }
+
+            placedGroup.m_LayoutEnd = fileLayoutOrder.size();
+            placedLoadGroups.push_back(placedGroup);
+        }
+
+        if (a_Settings.m_AccessTracePath != nullptr)
+        {
+            std::vector<ResourcePathHash> firstAccessOrder{};
+            std::unique_ptr<IFile> const traceFile = s_FileFactory(a_Settings.m_AccessTracePath, FileOpenMode::Read);
+            if (traceFile == nullptr || !ReadAccessTrace(*traceFile, firstAccessOrder))
+            {
+                hako::Log("Unable to read access trace \"%s\". Files will be laid out in hash order.\n", a_Settings.m_AccessTracePath);
+            }
+
+            for (ResourcePathHash const& hash : firstAccessOrder)
+            {
+                auto const it = fileIndices.find(hash);
+                if (it != fileIndices.end() && !isPlaced[it->second])
+                {
+                    fileLayoutOrder.push_back(it->second);
+                    isPlaced[it->second] = true;
+                }
+            }
+        }
 
-        // Create FileInfo objects and serialize file content to archive
         for (size_t fileIndex = 0; fileIndex < filePaths.size(); ++fileIndex)
         {
-            std::unique_ptr<IFile> currentFile = s_FileFactory(filePaths[fileIndex].m_FilePath.c_str(), FileOpenMode::Read);
+            if (!isPlaced[fileIndex])
+            {
+                fileLayoutOrder.push_back(fileIndex);
+            }
+        }
+
+        // The load group table is sorted by name, so groups can be found with a binary search
+        std::sort(placedLoadGroups.begin(), placedLoadGroups.end(), [](PlacedLoadGroup const& a_Lhs, PlacedLoadGroup const& a_Rhs)
+            {
+                return CompareHash(a_Lhs.m_NameHash, a_Rhs.m_NameHash) < 0;
+            }
+        );
+
+        ArchiveHeader header;
+        header.m_FileCount = filePaths.size();
+
+        if (a_Settings.m_Allow64BitHashes)
+        {
+            // Files are sorted by hash, so files that share the first 64 bits of their hash are adjacent
+            auto const collision = std::adjacent_find(filePaths.begin(), filePaths.end(), [](HashPathPair const& a_Lhs, HashPathPair const& a_Rhs)
+                {
+                    return a_Lhs.m_ResourcePathHash.hash64[0] == a_Rhs.m_ResourcePathHash.hash64[0];
+                }
+            );
+
+            if (collision == filePaths.end())
+            {
+                header.m_TableOfContentsFlags |= TableOfContents::Flag64BitHashes;
+            }
+            else
+            {
+                hako::Log("Files with hashes \"%s\" and \"%s\" share their first 64 bits. The archive will store 128-bit hashes.\n",
+                    collision->m_ResourcePathHash.ToString().c_str(), (collision + 1)->m_ResourcePathHash.ToString().c_str());
+            }
+        }
+
+        if (a_Settings.m_Allow32BitOffsets)
+        {
+            // Offsets aren't known until files are written, so bound the archive's size by storing every file uncompressed after as much padding as possible.
+            // Files are only stored compressed if that makes them smaller.
+            size_t archiveSizeBound = sizeof(ArchiveHeader) + TableOfContents::GetSize(filePaths.size(), header.m_TableOfContentsFlags)
+                + placedLoadGroups.size() * sizeof(Archive::LoadGroupInfo);
+            if (a_Settings.m_WriteLookupIndex)
+            {
+                archiveSizeBound += ((size_t{ 1 } << GetLookupIndexBucketBits(filePaths.size())) + 1) * sizeof(LookupIndexEntry);
+            }
+
+            for (HashPathPair const& filePath : filePaths)
+            {
+                archiveSizeBound += filePath.m_FileSize + entryAlignment - 1;
+            }
+
+            if (archiveSizeBound <= UINT32_MAX)
+            {
+                header.m_TableOfContentsFlags |= TableOfContents::Flag32BitOffsets;
+            }
+            else
+            {
+                hako::Log("Archive \"%s\" may be larger than 4 GiB. The archive will store 64-bit offsets and sizes.\n", a_ArchiveName);
+            }
+        }
+
+        size_t const tableOfContentsEnd = sizeof(ArchiveHeader) + TableOfContents::GetSize(filePaths.size(), header.m_TableOfContentsFlags);
+        size_t fileDataStart = tableOfContentsEnd;
+
+        if (a_Settings.m_WriteLookupIndex && !filePaths.empty())
+        {
+            header.m_LookupIndexBucketBits = GetLookupIndexBucketBits(filePaths.size());
+            header.m_LookupIndexOffset = fileDataStart;
+
+            // Files are sorted by hash, so every bucket's files are contiguous
+            std::vector<LookupIndexEntry> lookupIndex((size_t{ 1 } << header.m_LookupIndexBucketBits) + 1, 0);
+            size_t fileIndex = 0;
+            for (size_t bucket = 0; bucket < lookupIndex.size() - 1; ++bucket)
+            {
+                lookupIndex[bucket] = static_cast<LookupIndexEntry>(fileIndex);
+                while (fileIndex < filePaths.size() && GetLookupIndexBucket(filePaths[fileIndex].m_ResourcePathHash, header.m_LookupIndexBucketBits) == bucket)
+                {
+                    ++fileIndex;
+                }
+            }
+            lookupIndex.back() = static_cast<LookupIndexEntry>(filePaths.size());
+
+            size_t const lookupIndexSize = lookupIndex.size() * sizeof(LookupIndexEntry);
+            WriteToArchive(archive.get(), lookupIndex.data(), lookupIndexSize, header.m_LookupIndexOffset);
+            fileDataStart += lookupIndexSize;
+        }
+
+        if (!placedLoadGroups.empty())
+        {
+            // The table is written once the group's files are, as their offsets aren't known before then
+            header.m_LoadGroupCount = static_cast<uint32_t>(placedLoadGroups.size());
+            header.m_LoadGroupTableOffset = fileDataStart;
+            fileDataStart += placedLoadGroups.size() * sizeof(Archive::LoadGroupInfo);
+        }
+
+        WriteToArchive(archive.get(), &header, sizeof(ArchiveHeader), 0);
+
+        size_t fileDataEnd = fileDataStart;
+        // Start and end of every file's data, by position in fileLayoutOrder
+        std::vector<std::pair<size_t, size_t>> layoutRanges(fileLayoutOrder.size());
+
+        // The table of contents stays sorted by hash, regardless of where the files' data ends up
+        std::vector<Archive::FileInfo> tableOfContents(filePaths.size());
+
+        if (!a_Settings.m_CompressFiles)
+        {
+            // Uncompressed files are stored as they are, so the directory scan tells where every file goes.
+            // Padding between files is never written, so it reads as zeroes.
+            for (size_t layoutIndex = 0; layoutIndex < fileLayoutOrder.size(); ++layoutIndex)
+            {
+                size_t const offset = (fileDataEnd + entryAlignment - 1) & ~(entryAlignment - 1);
+                fileDataEnd = offset + filePaths[fileLayoutOrder[layoutIndex]].m_FileSize;
+                layoutRanges[layoutIndex] = { offset, fileDataEnd };
+            }
+        }
+
+        // Compressed files only know their size once they are compressed, so they are placed in layout order as they finish: every file waits for its turn,
+        // which is always held by a file that is already being archived, as the thread pool starts jobs in the order they are queued
+        std::mutex placementMutex;
+        std::condition_variable placementChanged;
+        size_t nextPlacedLayoutIndex = 0;
+        std::atomic<bool> filesChanged = false;
 
-            Archive::FileInfo fi{};
+        auto const archiveFile = [&](size_t a_LayoutIndex)
+        {
+            size_t const fileIndex = fileLayoutOrder[a_LayoutIndex];
+            Archive::FileInfo& fi = tableOfContents[fileIndex];
             fi.m_ResourcePathHash = filePaths[fileIndex].m_ResourcePathHash;
-            fi.m_Offset = sizeof(ArchiveHeader) + sizeof(Archive::FileInfo) * filePaths.size() + totalFileSize;
 
-            fi.m_Size = ArchiveFile(archive.get(), filePaths[fileIndex].m_FilePath.c_str(), fi);
-            totalFileSize += fi.m_Size;
+            ArchiveFile(archive.get(), filePaths[fileIndex].m_FilePath.c_str(), fi, a_Settings.m_CompressFiles, [&](std::optional<size_t> a_StoredSize) -> std::optional<size_t>
+                {
+                    if (!a_Settings.m_CompressFiles)
+                    {
+                        // Files that can't be read keep an empty entry, like in compressed archives. Their space stays unused padding.
+                        if (!a_StoredSize)
+                        {
+                            return std::nullopt;
+                        }
+
+                        std::pair<size_t, size_t> const& range = layoutRanges[a_LayoutIndex];
+                        if (*a_StoredSize != range.second - range.first)
+                        {
+                            // Writing the file would overwrite the files after it
+                            hako::Log("File %s changed while the archive was being created.\n", filePaths[fileIndex].m_FilePath.c_str());
+                            filesChanged = true;
+                            return std::nullopt;
+                        }
+
+                        return range.first;
+                    }
+
+                    std::unique_lock<std::mutex> lock(placementMutex);
+                    placementChanged.wait(lock, [&nextPlacedLayoutIndex, a_LayoutIndex]() { return nextPlacedLayoutIndex == a_LayoutIndex; });
+
+                    // Files that can't be read still take their turn, so the files after them don't wait forever
+                    size_t const offset = (fileDataEnd + entryAlignment - 1) & ~(entryAlignment - 1);
+                    fileDataEnd = offset + a_StoredSize.value_or(0);
+                    layoutRanges[a_LayoutIndex] = { offset, fileDataEnd };
+
+                    ++nextPlacedLayoutIndex;
+                    placementChanged.notify_all();
+                    return a_StoredSize ? std::optional<size_t>(offset) : std::nullopt;
+                }
+            );
+        };
+
+        // Files are copied on multiple threads if the archive can be written to at different offsets at the same time
+        size_t threadCount = a_Settings.m_ThreadCount > 0 ? a_Settings.m_ThreadCount : std::thread::hardware_concurrency();
+        threadCount = archive->SupportsConcurrentWrites() ? std::clamp<size_t>(threadCount, 1, std::max<size_t>(fileLayoutOrder.size(), 1)) : 1;
+
+        if (threadCount > 1)
+        {
+            ThreadPool threadPool(threadCount);
+            for (size_t layoutIndex = 0; layoutIndex < fileLayoutOrder.size(); ++layoutIndex)
+            {
+                threadPool.Enqueue([&archiveFile, layoutIndex]() { archiveFile(layoutIndex); });
+            }
+            threadPool.WaitUntilIdle();
+        }
+        else
+        {
+            for (size_t layoutIndex = 0; layoutIndex < fileLayoutOrder.size(); ++layoutIndex)
+            {
+                archiveFile(layoutIndex);
+            }
+        }
+
+        if (filesChanged)
+        {
+            hako::Log("Failed to create archive \"%s\" - intermediate files changed while it was being created.\n", a_ArchiveName);
+            return false;
+        }
+
+        // Compressed files are placed with the size they have when they are read, so files that grew since the directory scan can push the archive past the bound.
+        // The table of contents' size is already fixed by then, so it can't switch to 64-bit offsets.
+        if ((header.m_TableOfContentsFlags & TableOfContents::Flag32BitOffsets) != 0 && fileDataEnd > UINT32_MAX)
+        {
+            hako::Log("Failed to create archive \"%s\" - intermediate files grew while it was being created, so it no longer fits 32-bit offsets.\n", a_ArchiveName);
+            return false;
+        }
+
+        std::vector<char> tableOfContentsData{};
+        TableOfContents::Serialize(tableOfContents, header.m_TableOfContentsFlags, tableOfContentsData);
+        WriteToArchive(archive.get(), tableOfContentsData.data(), tableOfContentsData.size(), sizeof(ArchiveHeader));
+
+        if (!placedLoadGroups.empty())
+        {
+            std::vector<Archive::LoadGroupInfo> loadGroupTable(placedLoadGroups.size());
+            for (size_t groupIndex = 0; groupIndex < placedLoadGroups.size(); ++groupIndex)
+            {
+                PlacedLoadGroup const& placedGroup = placedLoadGroups[groupIndex];
+                Archive::LoadGroupInfo& groupInfo = loadGroupTable[groupIndex];
+                groupInfo.m_NameHash = placedGroup.m_NameHash;
+
+                // Groups without any archived files are kept, so loading them isn't an error
+                if (placedGroup.m_LayoutEnd > placedGroup.m_FirstLayoutIndex)
+                {
+                    groupInfo.m_Offset = layoutRanges[placedGroup.m_FirstLayoutIndex].first;
+                    groupInfo.m_Size = layoutRanges[placedGroup.m_LayoutEnd - 1].second - groupInfo.m_Offset;
+                }
+            }
 
-            // Write file info to the archive
-            WriteToArchive(archive.get(), &fi, sizeof(Archive::FileInfo), archiveInfoBytesWritten);
-            archiveInfoBytesWritten += sizeof(Archive::FileInfo);
+            WriteToArchive(archive.get(), loadGroupTable.data(), loadGroupTable.size() * sizeof(Archive::LoadGroupInfo), header.m_LoadGroupTableOffset);
         }
 
         return true;
@@ -460,29 +947,46 @@ namespace hako
     {
         HAKO_ASSERT(a_Path && a_Path[0] != 0, "No path provided\n");
 
-        MurmurHash3_x64_128(a_Path, strlen(a_Path), Murmur3Seed, a_OutHash.hash64);
+        a_OutHash = HashResourcePath(a_Path, strlen(a_Path));
     }
 }
 
 using namespace hako;
 
-Archive::Archive(char const* a_ArchivePath, char const* a_IntermediateDirectory, Platform a_Platform)
+Archive::Archive()
+    : m_TableOfContents(std::make_unique<TableOfContents>())
+    , m_ContentCache(std::make_unique<ContentCache>())
+    , m_Statistics(std::make_unique<ArchiveStatistics>())
+{ }
+
+Archive::Archive(char const* a_ArchivePath, char const* a_IntermediateDirectory, Platform a_Platform, FileOpenMode a_OpenMode)
+    : m_TableOfContents(std::make_unique<TableOfContents>())
+    , m_ContentCache(std::make_unique<ContentCache>())
+    , m_Statistics(std::make_unique<ArchiveStatistics>())
+{
+    Open(a_ArchivePath, a_IntermediateDirectory, a_Platform, a_OpenMode);
+}
+
+Archive::~Archive()
 {
-    Open(a_ArchivePath, a_IntermediateDirectory, a_Platform);
+    Close();
 }
 
-void Archive::Open(char const* a_ArchivePath, char const* a_IntermediateDirectory, Platform a_Platform)
+void Archive::Open(char const* a_ArchivePath, char const* a_IntermediateDirectory, Platform a_Platform, FileOpenMode a_OpenMode)
 {
     HAKO_ASSERT(m_ArchiveReader == nullptr, "An archive has already been opened. Close it before opening another one.");
 
     HAKO_ASSERT(a_ArchivePath && a_ArchivePath[0] != 0, "No archive path provided\n");
+    HAKO_ASSERT(a_OpenMode == FileOpenMode::Read || a_OpenMode == FileOpenMode::ReadMapped || a_OpenMode == FileOpenMode::ReadDirect, "Archives can only be opened in a read mode\n");
 
-    m_FilesInArchive.clear();
+    m_TableOfContents->Clear();
 
     // Open archive
-    m_ArchiveReader = s_FileFactory(a_ArchivePath, FileOpenMode::Read);
+    m_ArchiveReader = s_FileFactory(a_ArchivePath, a_OpenMode);
     HAKO_ASSERT(m_ArchiveReader != nullptr, "Unable to open archive \"%s\" for reading!\n", a_ArchivePath);
 
+    m_MappedArchive = m_ArchiveReader->GetMappedContent();
+
 #ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
     if (a_IntermediateDirectory)
     {
@@ -499,127 +1003,1373 @@ void Archive::Open(char const* a_ArchivePath, char const* a_IntermediateDirector
         hako::Log("Intermediate directory \"%s\" does not exist.\n", IntermediateDirectory.c_str());
     }
 
-    m_LastWriteTimestamp = std::filesystem::last_write_time(a_ArchivePath).time_since_epoch().count();
     m_CurrentPlatform = a_Platform;
+    m_IntermediateOverlay = std::make_unique<IntermediateOverlay>(GetIntermediateDirectoryPath(a_Platform), std::filesystem::last_write_time(a_ArchivePath));
 #endif
 
-    // Read from archive
+    ReadTableOfContents();
+}
+
+void Archive::OpenFromMemory(Span<char const> a_ArchiveData)
+{
+    HAKO_ASSERT(m_ArchiveReader == nullptr, "An archive has already been opened. Close it before opening another one.");
+    HAKO_ASSERT(!a_ArchiveData.empty(), "No archive data provided\n");
+
+    m_TableOfContents->Clear();
+
+    // Every read becomes a copy out of (or a view into) the caller's memory
+    m_ArchiveReader = std::make_unique<MemoryFile>(a_ArchiveData);
+    m_MappedArchive = m_ArchiveReader->GetMappedContent();
+
+    ReadTableOfContents();
+}
+
+void Archive::ReadTableOfContents()
+{
+    size_t const archiveSize = m_ArchiveReader->GetFileSize();
+    if (archiveSize < sizeof(ArchiveHeader))
+    {
+        HAKO_ASSERT(false, "The archive is too small to be a Hako archive, or the file might be corrupted.\n");
+        Close();
+        return;
+    }
+
     std::vector<char> buffer{};
     buffer.resize(sizeof(ArchiveHeader));
     m_ArchiveReader->Read(sizeof(ArchiveHeader), 0, buffer);
 
-    ArchiveHeader const header = *reinterpret_cast<ArchiveHeader*>(buffer.data());
+    ArchiveHeader header;
+    memcpy(&header, buffer.data(), sizeof(ArchiveHeader));
     HAKO_ASSERT(memcmp(header.m_Magic, ArchiveMagic, MagicLength) == 0, "The archive does not seem to a Hako archive, or the file might be corrupted.\n");
     HAKO_ASSERT(header.m_ArchiveVersion == ArchiveVersion, "Archive version mismatch. The archive should be rebuilt.\n");
 
-    buffer.reserve(sizeof(FileInfo));
-    size_t bytesRead = header.m_HeaderSize;
+    if ((header.m_TableOfContentsFlags & ~TableOfContents::ValidFlags) != 0)
+    {
+        HAKO_ASSERT(false, "The archive's table of contents is stored in an unknown format. The file might be corrupted.\n");
+        Close();
+        return;
+    }
 
-    for (size_t fileNum = 0; fileNum < header.m_FileCount; ++fileNum)
+    // Read the entire table of contents at once
+    size_t const tableOfContentsSize = TableOfContents::GetSize(header.m_FileCount, header.m_TableOfContentsFlags);
+    if (header.m_HeaderSize > archiveSize || tableOfContentsSize > archiveSize - header.m_HeaderSize)
     {
-        buffer.clear();
-        buffer.resize(sizeof(FileInfo));
+        HAKO_ASSERT(false, "The archive's table of contents is truncated. The file might be corrupted.\n");
+        Close();
+        return;
+    }
 
-        m_ArchiveReader->Read(sizeof(FileInfo), bytesRead, buffer);
-        bytesRead += sizeof(FileInfo);
+    m_TableOfContents->Allocate(header.m_FileCount, header.m_TableOfContentsFlags);
 
-        m_FilesInArchive.push_back(*reinterpret_cast<FileInfo*>(buffer.data()));
+    if (!m_MappedArchive.empty())
+    {
+        memcpy(m_TableOfContents->GetData(), m_MappedArchive.data() + header.m_HeaderSize, tableOfContentsSize);
+    }
+    else
+    {
+        if (!m_ArchiveReader->Read(tableOfContentsSize, header.m_HeaderSize, m_TableOfContents->GetData()))
+        {
+            HAKO_ASSERT(false, "Unable to read the archive's table of contents.\n");
+            Close();
+            return;
+        }
     }
-}
-
-void Archive::Close()
-{
-    m_FilesInArchive.clear();
-    m_LastWriteTimestamp = 0;
-    m_ArchiveReader = nullptr;
 
-}
+    if (!ValidateTableOfContents(archiveSize))
+    {
+        HAKO_ASSERT(false, "The archive's table of contents is invalid. The file might be corrupted.\n");
+        Close();
+        return;
+    }
 
-bool Archive::ReadFile(char const* a_FileName, std::vector<char>& a_OutData) const
-{
-    ResourcePathHash hash;
-    GetResourcePathHash(a_FileName, hash);
+    if (header.m_LookupIndexOffset != 0 && !ReadLookupIndex(header.m_LookupIndexOffset, header.m_LookupIndexBucketBits, archiveSize))
+    {
+        HAKO_ASSERT(false, "The archive's lookup index is invalid. The file might be corrupted.\n");
+        Close();
+        return;
+    }
 
-    return ReadFile(hash, a_OutData);
+    if (header.m_LoadGroupCount > 0 && !ReadLoadGroupTable(header.m_LoadGroupTableOffset, header.m_LoadGroupCount, archiveSize))
+    {
+        HAKO_ASSERT(false, "The archive's load group table is invalid. The file might be corrupted.\n");
+        Close();
+    }
 }
 
-bool Archive::ReadFile(ResourcePathHash const& a_ResourcePathHash, std::vector<char>& a_OutData) const
+bool Archive::ReadLookupIndex(size_t a_Offset, uint8_t a_BucketBits, size_t a_ArchiveSize)
 {
-#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+    if (a_BucketBits > MaxLookupIndexBucketBits)
+    {
+        return false;
+    }
 
-    if (ReadFileOutsideArchive(a_ResourcePathHash, a_OutData))
+    size_t const entryCount = (size_t{ 1 } << a_BucketBits) + 1;
+    size_t const lookupIndexSize = entryCount * sizeof(LookupIndexEntry);
+    if (a_Offset > a_ArchiveSize || lookupIndexSize > a_ArchiveSize - a_Offset)
     {
-        return true;
+        return false;
     }
-#endif
 
-    FileInfo const* fi = GetFileInfo(a_ResourcePathHash);
-    HAKO_ASSERT(fi != nullptr, "Unable to find file with hash \"%s\" in archive.\n", a_ResourcePathHash.ToString().c_str());
+    m_LookupIndex.resize(entryCount);
+    if (!m_ArchiveReader->Read(lookupIndexSize, a_Offset, reinterpret_cast<char*>(m_LookupIndex.data())))
+    {
+        m_LookupIndex.clear();
+        return false;
+    }
+
+    m_LookupIndexBucketBits = a_BucketBits;
+
+    // Check that every file is in the bucket its hash maps to, so lookups can trust the index
+    bool valid = m_LookupIndex.front() == 0 && m_LookupIndex.back() == m_TableOfContents->GetFileCount();
+    for (size_t bucket = 0; valid && bucket + 1 < entryCount; ++bucket)
+    {
+        valid = m_LookupIndex[bucket] <= m_LookupIndex[bucket + 1];
+        for (size_t fileIndex = m_LookupIndex[bucket]; valid && fileIndex < m_LookupIndex[bucket + 1]; ++fileIndex)
+        {
+            valid = GetLookupIndexBucket(m_TableOfContents->GetHash(fileIndex), m_LookupIndexBucketBits) == bucket;
+        }
+    }
+
+    if (!valid)
+    {
+        m_LookupIndex.clear();
+    }
+
+    return valid;
+}
+
+bool Archive::ReadLoadGroupTable(size_t a_Offset, uint32_t a_GroupCount, size_t a_ArchiveSize)
+{
+    size_t const tableSize = static_cast<size_t>(a_GroupCount) * sizeof(LoadGroupInfo);
+    if (a_Offset > a_ArchiveSize || tableSize > a_ArchiveSize - a_Offset)
+    {
+        return false;
+    }
+
+    m_LoadGroups.resize(a_GroupCount);
+    if (!m_ArchiveReader->Read(tableSize, a_Offset, reinterpret_cast<char*>(m_LoadGroups.data())))
+    {
+        m_LoadGroups.clear();
+        return false;
+    }
+
+    // FindLoadGroupInfo() relies on the groups being sorted by name, and LoadGroup() on their ranges lying within the archive
+    bool valid = true;
+    for (size_t groupIndex = 0; valid && groupIndex < m_LoadGroups.size(); ++groupIndex)
+    {
+        LoadGroupInfo const& group = m_LoadGroups[groupIndex];
+        valid = group.m_Offset <= a_ArchiveSize && group.m_Size <= a_ArchiveSize - group.m_Offset
+            && (groupIndex == 0 || CompareHash(m_LoadGroups[groupIndex - 1].m_NameHash, group.m_NameHash) < 0);
+    }
+
+    if (!valid)
+    {
+        m_LoadGroups.clear();
+    }
+
+    return valid;
+}
+
+void Archive::Close()
+{
+    // Finish pending asynchronous reads before the archive goes away
+    std::unique_ptr<ThreadPool> ioThreadPool = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_IOThreadPoolMutex);
+        ioThreadPool = std::move(m_IOThreadPool);
+    }
+
+    // The pool can't wait for the job that is closing the archive. It still shuts down safely, but reads that were queued behind the job run during Close().
+    HAKO_ASSERT(ioThreadPool == nullptr || !ioThreadPool->IsWorkerThread(), "An archive must not be closed or destroyed from one of its asynchronous read callbacks\n");
+    ioThreadPool = nullptr;
+
+    StopAccessTrace();
+    m_ContentCache->Clear();
+    m_TableOfContents->Clear();
+    m_LookupIndex.clear();
+    m_LookupIndexBucketBits = 0;
+    m_LoadGroups.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_LoadedGroupsMutex);
+        m_LoadedGroups.clear();
+        m_HasLoadedGroups = false;
+    }
+    m_IntermediateOverlay = nullptr;
+    m_MappedArchive = {};
+    m_ArchiveReader = nullptr;
+}
+
+bool Archive::IsOpen() const
+{
+    return m_ArchiveReader != nullptr;
+}
+
+bool Archive::HasTruncatedHashes() const
+{
+    return (m_TableOfContents->GetFlags() & TableOfContents::Flag64BitHashes) != 0;
+}
+
+bool Archive::ReadFile(char const* a_FileName, std::vector<char>& a_OutData) const
+{
+    ResourcePathHash hash;
+    GetResourcePathHash(a_FileName, hash);
+
+    return ReadFile(hash, a_OutData);
+}
+
+bool Archive::ReadFile(ResourcePathHash const& a_ResourcePathHash, std::vector<char>& a_OutData) const
+{
+    return ReadFile(a_ResourcePathHash, nullptr, a_OutData);
+}
+
+bool Archive::ReadFile(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo, std::vector<char>& a_OutData) const
+{
+    if (m_ContentCache->IsEnabled())
+    {
+        auto const buffer = ReadFileShared(a_ResourcePathHash, a_FileInfo);
+        if (buffer == nullptr)
+        {
+            return false;
+        }
+
+        a_OutData.assign(buffer->begin(), buffer->end());
+        return true;
+    }
+
+    RecordAccess(a_ResourcePathHash);
+
+#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+
+    if (ReadFileOutsideArchive(a_ResourcePathHash, a_OutData))
+    {
+        return true;
+    }
+#endif
+
+    std::optional<FileInfo> const fi = GetFileInfo(a_ResourcePathHash, a_FileInfo);
+    HAKO_ASSERT(fi.has_value(), "Unable to find file with hash \"%s\" in archive.\n", a_ResourcePathHash.ToString().c_str());
+    if (!fi)
+    {
+        return false;
+    }
 
     return LoadFileContent(*fi, a_OutData);
 }
 
-Archive::FileInfo const* Archive::GetFileInfo(ResourcePathHash const& a_ResourcePathHash) const
+bool Archive::ReadFile(ResourcePathHash const& a_ResourcePathHash, char* a_OutBuffer, size_t a_BufferSize) const
 {
-    HAKO_ASSERT(!m_FilesInArchive.empty(), "Archive is empty");
+    return ReadFile(a_ResourcePathHash, nullptr, a_OutBuffer, a_BufferSize);
+}
 
-    // Find file (assumes that file names were sorted before this)
-    auto const foundFile = std::lower_bound(m_FilesInArchive.begin(), m_FilesInArchive.end(), a_ResourcePathHash, [](FileInfo const& a_Lhs, ResourcePathHash const& a_Rhs)
+bool Archive::ReadFile(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo, char* a_OutBuffer, size_t a_BufferSize) const
+{
+    return ReadFileIntoBuffer(a_ResourcePathHash, a_FileInfo, [&a_ResourcePathHash, a_OutBuffer, a_BufferSize](size_t a_FileSize, char*& a_Buffer)
         {
-            return CompareHash(a_Lhs.m_ResourcePathHash, a_Rhs) < 0;
+            if (a_FileSize > a_BufferSize)
+            {
+                hako::Log("Buffer is too small to read file with hash \"%s\" into.\n", a_ResourcePathHash.ToString().c_str());
+                return false;
+            }
+
+            a_Buffer = a_OutBuffer;
+            return true;
         }
     );
+}
+
+bool Archive::ReadFileIntoBuffer(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo, GetReadBufferFunction const& a_GetBuffer) const
+{
+    char* buffer = nullptr;
 
-    if (foundFile == m_FilesInArchive.end() || foundFile->m_ResourcePathHash != a_ResourcePathHash)
+    if (m_ContentCache->IsEnabled())
     {
-        return nullptr;
+        auto const content = ReadFileShared(a_ResourcePathHash, a_FileInfo);
+        if (content == nullptr || !a_GetBuffer(content->size(), buffer))
+        {
+            return false;
+        }
+
+        if (!content->empty())
+        {
+            memcpy(buffer, content->data(), content->size());
+        }
+        return true;
+    }
+
+    RecordAccess(a_ResourcePathHash);
+
+#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+    if (std::unique_ptr<IFile> const file = OpenFileOutsideArchive(a_ResourcePathHash))
+    {
+        size_t const fileSize = file->GetFileSize();
+        return a_GetBuffer(fileSize, buffer) && file->Read(fileSize, 0, buffer);
+    }
+#endif
+
+    std::optional<FileInfo> const fi = GetFileInfo(a_ResourcePathHash, a_FileInfo);
+    HAKO_ASSERT(fi.has_value(), "Unable to find file with hash \"%s\" in archive.\n", a_ResourcePathHash.ToString().c_str());
+    if (!fi)
+    {
+        return false;
     }
 
-    return &(*foundFile);
+    return a_GetBuffer(fi->m_Size, buffer) && LoadFileContent(*fi, buffer);
 }
 
-bool Archive::ReadFileOutsideArchive(ResourcePathHash const& a_Hash, std::vector<char>& a_OutData) const
+size_t Archive::GetFileSize(ResourcePathHash const& a_ResourcePathHash) const
 {
 #ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
-    auto const intermediatePath = GetIntermediateFilePath(m_CurrentPlatform, a_Hash);
-    if (!std::filesystem::exists(intermediatePath))
+    if (std::unique_ptr<IFile> const file = OpenFileOutsideArchive(a_ResourcePathHash))
     {
-        return false;
+        return file->GetFileSize();
+    }
+#endif
+
+    std::optional<FileInfo> const fi = GetFileInfo(a_ResourcePathHash);
+    return fi ? fi->m_Size : 0;
+}
+
+void* Archive::ReadRelocatable(ResourcePathHash const& a_ResourcePathHash, std::vector<char>& a_OutData) const
+{
+    if (!ReadFile(a_ResourcePathHash, a_OutData))
+    {
+        return nullptr;
     }
 
-    auto const lastIntermediateFileWriteTime = std::filesystem::last_write_time(intermediatePath).time_since_epoch().count();
-    if (lastIntermediateFileWriteTime <= m_LastWriteTimestamp)
+    return FixupRelocatableBlob(a_OutData.data(), a_OutData.size());
+}
+
+void* Archive::ReadRelocatable(ResourcePathHash const& a_ResourcePathHash, char* a_OutBuffer, size_t a_BufferSize) const
+{
+    size_t const fileSize = GetFileSize(a_ResourcePathHash);
+    if (fileSize == 0 || !ReadFile(a_ResourcePathHash, a_OutBuffer, a_BufferSize))
     {
-        // File hasn't been updated since the archive was created, so we can just read it from the archive
         return nullptr;
     }
 
-    // Try to open the file
-    std::unique_ptr<IFile> const file = s_FileFactory(intermediatePath.generic_string().c_str(), FileOpenMode::Read);
+    return FixupRelocatableBlob(a_OutBuffer, fileSize);
+}
 
-    if (file == nullptr)
+bool Archive::ReadRange(ResourcePathHash const& a_ResourcePathHash, size_t a_Offset, size_t a_NumBytes, char* a_OutBuffer) const
+{
+    return ReadRange(a_ResourcePathHash, nullptr, a_Offset, a_NumBytes, a_OutBuffer);
+}
+
+bool Archive::ReadRange(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo, size_t a_Offset, size_t a_NumBytes, char* a_OutBuffer) const
+{
+    RecordAccess(a_ResourcePathHash);
+
+#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+    if (std::unique_ptr<IFile> const file = OpenFileOutsideArchive(a_ResourcePathHash))
+    {
+        size_t const fileSize = file->GetFileSize();
+        if (a_Offset > fileSize || a_NumBytes > fileSize - a_Offset)
+        {
+            hako::Log("Range to read lies outside of file with hash \"%s\".\n", a_ResourcePathHash.ToString().c_str());
+            return false;
+        }
+
+        return file->Read(a_NumBytes, a_Offset, a_OutBuffer);
+    }
+#endif
+
+    std::optional<FileInfo> const fi = GetFileInfo(a_ResourcePathHash, a_FileInfo);
+    HAKO_ASSERT(fi.has_value(), "Unable to find file with hash \"%s\" in archive.\n", a_ResourcePathHash.ToString().c_str());
+    if (!fi)
     {
-        // File doesn't exist outside of the archive, or it can't be opened
         return false;
     }
 
-    // Read intermediate file content
-    size_t const fileSize = file->GetFileSize();
+    if (a_Offset > fi->m_Size || a_NumBytes > fi->m_Size - a_Offset)
+    {
+        hako::Log("Range to read lies outside of file with hash \"%s\".\n", a_ResourcePathHash.ToString().c_str());
+        return false;
+    }
+
+    return LoadFileRange(*fi, a_Offset, a_NumBytes, a_OutBuffer);
+}
+
+bool Archive::ReadRange(ResourcePathHash const& a_ResourcePathHash, size_t a_Offset, size_t a_NumBytes, std::vector<char>& a_OutData) const
+{
     a_OutData.clear();
-    a_OutData.resize(fileSize);
+    a_OutData.resize(a_NumBytes);
 
-    if (file->Read(fileSize, 0, a_OutData))
+    return ReadRange(a_ResourcePathHash, a_Offset, a_NumBytes, a_OutData.data());
+}
+
+bool Archive::ReadFiles(Span<ResourcePathHash const> a_ResourcePathHashes, Span<std::vector<char>> a_OutData) const
+{
+    HAKO_ASSERT(a_ResourcePathHashes.size() == a_OutData.size(), "The number of output vectors does not match the number of files to read\n");
+
+    struct PendingRead
     {
-        return true;
+        FileInfo m_FileInfo{};
+        size_t m_OutIndex = 0;
+    };
+
+    std::vector<PendingRead> pendingReads{};
+    pendingReads.reserve(a_ResourcePathHashes.size());
+
+    bool success = true;
+
+    for (size_t fileIndex = 0; fileIndex < a_ResourcePathHashes.size(); ++fileIndex)
+    {
+        ResourcePathHash const& hash = a_ResourcePathHashes[fileIndex];
+        RecordAccess(hash);
+
+#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+        if (ReadFileOutsideArchive(hash, a_OutData[fileIndex]))
+        {
+            continue;
+        }
+#endif
+
+        std::optional<FileInfo> const fi = GetFileInfo(hash);
+        HAKO_ASSERT(fi.has_value(), "Unable to find file with hash \"%s\" in archive.\n", hash.ToString().c_str());
+        if (!fi)
+        {
+            success = false;
+            continue;
+        }
+
+        std::shared_ptr<ReadBuffer const> groupData = nullptr;
+        if (GetStoredData(*fi, groupData) != nullptr)
+        {
+            // Mapped files and files of loaded groups don't need any I/O from our side
+            success &= LoadFileContent(*fi, a_OutData[fileIndex]);
+            continue;
+        }
+
+        pendingReads.push_back({ *fi, fileIndex });
+    }
+
+    std::sort(pendingReads.begin(), pendingReads.end(), [](PendingRead const& a_Lhs, PendingRead const& a_Rhs)
+        {
+            return a_Lhs.m_FileInfo.m_Offset < a_Rhs.m_FileInfo.m_Offset;
+        }
+    );
+
+    ReadBuffer coalescedData{};
+
+    size_t firstRead = 0;
+    while (firstRead < pendingReads.size())
+    {
+        // Grow the range for as long as the next file starts close enough to the end of the range
+        size_t const rangeStart = pendingReads[firstRead].m_FileInfo.m_Offset;
+        size_t rangeEnd = rangeStart + pendingReads[firstRead].m_FileInfo.m_StoredSize;
+        size_t lastRead = firstRead + 1;
+
+        while (lastRead < pendingReads.size())
+        {
+            FileInfo const& next = pendingReads[lastRead].m_FileInfo;
+            size_t const nextEnd = std::max(rangeEnd, next.m_Offset + next.m_StoredSize);
+            if (next.m_Offset > rangeEnd + MaxCoalescedReadGap || nextEnd - rangeStart > MaxCoalescedReadSize)
+            {
+                break;
+            }
+
+            rangeEnd = nextEnd;
+            ++lastRead;
+        }
+
+        ArchiveStatistics::Timer const rangeTimer{};
+
+        if (lastRead == firstRead + 1)
+        {
+            // Nothing to coalesce, so read straight into the output
+            PendingRead const& read = pendingReads[firstRead];
+            success &= LoadFileContent(read.m_FileInfo, a_OutData[read.m_OutIndex]);
+        }
+        else if (ReadArchiveRange(rangeEnd - rangeStart, rangeStart, coalescedData))
+        {
+            bool const verifyChecksums = m_VerifyChecksums.load(std::memory_order_relaxed);
+            size_t filesRead = 0;
+            size_t bytesRead = 0;
+
+            for (size_t readIndex = firstRead; readIndex < lastRead; ++readIndex)
+            {
+                PendingRead const& read = pendingReads[readIndex];
+                FileInfo const& fi = read.m_FileInfo;
+                std::vector<char>& outData = a_OutData[read.m_OutIndex];
+                char const* const storedData = coalescedData.data() + (fi.m_Offset - rangeStart);
+
+                if (verifyChecksums && !IsChecksumValid(fi, storedData))
+                {
+                    outData.clear();
+                    success = false;
+                    continue;
+                }
+
+                if (fi.m_Compression == Compression::None)
+                {
+                    outData.assign(storedData, storedData + fi.m_Size);
+                }
+                else
+                {
+                    outData.clear();
+                    outData.resize(fi.m_Size);
+                    if (!DecodeFileContent(fi, storedData, outData.data()))
+                    {
+                        success = false;
+                        continue;
+                    }
+                }
+
+                ++filesRead;
+                bytesRead += fi.m_Size;
+            }
+
+            m_Statistics->RecordRead(filesRead, bytesRead, rangeTimer);
+        }
+        else
+        {
+            success = false;
+        }
+
+        firstRead = lastRead;
+    }
+
+    return success;
+}
+
+std::future<bool> Archive::ReadFileAsync(ResourcePathHash const& a_ResourcePathHash, std::vector<char>& a_OutData) const
+{
+    auto const task = std::make_shared<std::packaged_task<bool()>>([this, a_ResourcePathHash, &a_OutData]()
+        {
+            return ReadFile(a_ResourcePathHash, a_OutData);
+        }
+    );
+
+    std::future<bool> result = task->get_future();
+    GetIOThreadPool().Enqueue([task]() { (*task)(); });
+
+    return result;
+}
+
+void Archive::ReadFileAsync(ResourcePathHash const& a_ResourcePathHash, ReadFileCallback a_Callback) const
+{
+    HAKO_ASSERT(a_Callback != nullptr, "No callback provided for asynchronous read\n");
+
+    GetIOThreadPool().Enqueue([this, a_ResourcePathHash, callback = std::move(a_Callback)]()
+        {
+            std::vector<char> data{};
+            bool const success = ReadFile(a_ResourcePathHash, data);
+            callback(a_ResourcePathHash, success, data);
+        }
+    );
+}
+
+Span<char const> Archive::ReadFileView(char const* a_FileName) const
+{
+    ResourcePathHash hash;
+    GetResourcePathHash(a_FileName, hash);
+
+    return ReadFileView(hash);
+}
+
+Span<char const> Archive::ReadFileView(ResourcePathHash const& a_ResourcePathHash) const
+{
+    return ReadFileView(a_ResourcePathHash, nullptr);
+}
+
+Span<char const> Archive::ReadFileView(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo) const
+{
+    RecordAccess(a_ResourcePathHash);
+
+    if (m_MappedArchive.empty())
+    {
+        hako::Log("Unable to view file with hash \"%s\", as the archive is not mapped into memory.\n", a_ResourcePathHash.ToString().c_str());
+        return {};
+    }
+
+#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+    if (HasNewerFileOutsideArchive(a_ResourcePathHash))
+    {
+        // The up-to-date content doesn't live in the archive, so it can only be read with ReadFile()
+        hako::Log("Unable to view file with hash \"%s\", as it was updated outside of the archive.\n", a_ResourcePathHash.ToString().c_str());
+        return {};
     }
 #endif
 
-    return false;
+    std::optional<FileInfo> const fi = GetFileInfo(a_ResourcePathHash, a_FileInfo);
+    if (!fi)
+    {
+        return {};
+    }
+
+    if (fi->m_Compression != Compression::None)
+    {
+        hako::Log("Unable to view file with hash \"%s\", as it is compressed.\n", a_ResourcePathHash.ToString().c_str());
+        return {};
+    }
+
+    if (m_VerifyChecksums.load(std::memory_order_relaxed) && !IsChecksumValid(*fi, m_MappedArchive.data() + fi->m_Offset))
+    {
+        return {};
+    }
+
+    return m_MappedArchive.subspan(fi->m_Offset, fi->m_Size);
 }
 
-bool Archive::LoadFileContent(FileInfo const& a_FileInfo, std::vector<char>& a_Data) const
+bool Archive::LoadGroup(char const* a_GroupName)
 {
-    a_Data.clear();
-    a_Data.resize(a_FileInfo.m_Size);
-    return m_ArchiveReader->Read(a_FileInfo.m_Size, a_FileInfo.m_Offset, a_Data);
+    ResourcePathHash hash;
+    GetResourcePathHash(a_GroupName, hash);
+
+    return LoadGroup(hash);
+}
+
+bool Archive::LoadGroup(ResourcePathHash const& a_GroupNameHash)
+{
+    LoadGroupInfo const* group = FindLoadGroupInfo(a_GroupNameHash);
+    if (group == nullptr)
+    {
+        hako::Log("Unable to find load group with hash \"%s\" in archive.\n", a_GroupNameHash.ToString().c_str());
+        return false;
+    }
+
+    if (!m_MappedArchive.empty())
+    {
+        // Reads are served from the mapping anyway, so only let the OS start paging the group in
+        std::unique_lock<std::mutex> lock(m_ArchiveReaderMutex, std::defer_lock);
+        if (!m_ArchiveReader->SupportsConcurrentReads())
+        {
+            lock.lock();
+        }
+
+        m_ArchiveReader->Prefetch(group->m_Size, group->m_Offset);
+        return true;
+    }
+
+    auto const isLoaded = [this, &a_GroupNameHash]()
+    {
+        return std::any_of(m_LoadedGroups.begin(), m_LoadedGroups.end(), [&a_GroupNameHash](LoadedGroup const& a_LoadedGroup)
+            {
+                return a_LoadedGroup.m_NameHash == a_GroupNameHash;
+            }
+        );
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(m_LoadedGroupsMutex);
+        if (group->m_Size == 0 || isLoaded())
+        {
+            return true;
+        }
+    }
+
+    // Read the whole group with one sequential read, without holding the lock
+    ArchiveStatistics::Timer const timer{};
+    auto data = std::make_shared<ReadBuffer>();
+    if (!ReadArchiveRange(group->m_Size, group->m_Offset, *data))
+    {
+        hako::Log("Unable to read load group with hash \"%s\" from archive.\n", a_GroupNameHash.ToString().c_str());
+        return false;
+    }
+
+    m_Statistics->RecordRead(1, group->m_Size, timer);
+
+    std::lock_guard<std::mutex> lock(m_LoadedGroupsMutex);
+    if (!isLoaded())
+    {
+        m_LoadedGroups.push_back({ a_GroupNameHash, group->m_Offset, std::move(data) });
+        m_HasLoadedGroups = true;
+    }
+
+    return true;
+}
+
+void Archive::UnloadGroup(char const* a_GroupName)
+{
+    ResourcePathHash hash;
+    GetResourcePathHash(a_GroupName, hash);
+
+    UnloadGroup(hash);
+}
+
+void Archive::UnloadGroup(ResourcePathHash const& a_GroupNameHash)
+{
+    std::lock_guard<std::mutex> lock(m_LoadedGroupsMutex);
+
+    // Reads that are still using the group's data keep it alive until they finish
+    m_LoadedGroups.erase(std::remove_if(m_LoadedGroups.begin(), m_LoadedGroups.end(), [&a_GroupNameHash](LoadedGroup const& a_LoadedGroup)
+        {
+            return a_LoadedGroup.m_NameHash == a_GroupNameHash;
+        }
+    ), m_LoadedGroups.end());
+
+    m_HasLoadedGroups = !m_LoadedGroups.empty();
+}
+
+Archive::LoadGroupInfo const* Archive::FindLoadGroupInfo(ResourcePathHash const& a_GroupNameHash) const
+{
+    auto const foundGroup = std::lower_bound(m_LoadGroups.begin(), m_LoadGroups.end(), a_GroupNameHash, [](LoadGroupInfo const& a_Lhs, ResourcePathHash const& a_Rhs)
+        {
+            return CompareHash(a_Lhs.m_NameHash, a_Rhs) < 0;
+        }
+    );
+
+    if (foundGroup == m_LoadGroups.end() || foundGroup->m_NameHash != a_GroupNameHash)
+    {
+        return nullptr;
+    }
+
+    return &(*foundGroup);
+}
+
+char const* Archive::GetStoredData(FileInfo const& a_FileInfo, std::shared_ptr<ReadBuffer const>& a_OutGroupData) const
+{
+    if (!m_MappedArchive.empty())
+    {
+        return m_MappedArchive.data() + a_FileInfo.m_Offset;
+    }
+
+    if (!m_HasLoadedGroups.load(std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_LoadedGroupsMutex);
+    for (LoadedGroup const& group : m_LoadedGroups)
+    {
+        if (a_FileInfo.m_Offset >= group.m_Offset && a_FileInfo.m_StoredSize <= group.m_Data->size()
+            && a_FileInfo.m_Offset - group.m_Offset <= group.m_Data->size() - a_FileInfo.m_StoredSize)
+        {
+            a_OutGroupData = group.m_Data;
+            return group.m_Data->data() + (a_FileInfo.m_Offset - group.m_Offset);
+        }
+    }
+
+    return nullptr;
+}
+
+bool Archive::ValidateTableOfContents(size_t a_ArchiveSize) const
+{
+    for (size_t fileIndex = 0; fileIndex < m_TableOfContents->GetFileCount(); ++fileIndex)
+    {
+        FileInfo const fi = m_TableOfContents->GetFileInfo(fileIndex);
+
+        if (fi.m_Offset > a_ArchiveSize || fi.m_StoredSize > a_ArchiveSize - fi.m_Offset)
+        {
+            hako::Log("File with hash \"%s\" lies outside of the archive.\n", fi.m_ResourcePathHash.ToString().c_str());
+            return false;
+        }
+
+        bool const validCompression = (fi.m_Compression == Compression::None && fi.m_StoredSize == fi.m_Size)
+            || (fi.m_Compression == Compression::LZ && fi.m_StoredSize >= GetCompressionChunkTableSize(fi.m_Size));
+        if (!validCompression)
+        {
+            hako::Log("File with hash \"%s\" has an invalid compression method or size.\n", fi.m_ResourcePathHash.ToString().c_str());
+            return false;
+        }
+
+        // GetFileInfo() relies on the files being sorted by hash
+        if (fileIndex > 0 && !m_TableOfContents->IsSortedAfterPrevious(fileIndex))
+        {
+            hako::Log("The archive's table of contents is not sorted.\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::optional<Archive::FileInfo> Archive::GetFileInfo(ResourcePathHash const& a_ResourcePathHash) const
+{
+    ArchiveStatistics::Timer const timer = ArchiveStatistics::StartLookupTimer();
+    std::optional<FileInfo> fi = FindFileInfo(a_ResourcePathHash);
+    m_Statistics->RecordLookup(fi.has_value(), timer);
+
+    return fi;
+}
+
+std::optional<Archive::FileInfo> Archive::GetFileInfo(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo) const
+{
+    if (a_FileInfo != nullptr)
+    {
+        return *a_FileInfo;
+    }
+
+    return GetFileInfo(a_ResourcePathHash);
+}
+
+std::optional<Archive::FileInfo> Archive::FindFileInfo(ResourcePathHash const& a_ResourcePathHash) const
+{
+    size_t const fileCount = m_TableOfContents->GetFileCount();
+    HAKO_ASSERT(fileCount > 0, "Archive is empty");
+
+    size_t fileIndex = TableOfContents::NotFound;
+    if (!m_LookupIndex.empty())
+    {
+        size_t const bucket = GetLookupIndexBucket(a_ResourcePathHash, m_LookupIndexBucketBits);
+        fileIndex = m_TableOfContents->Find(a_ResourcePathHash, m_LookupIndex[bucket], m_LookupIndex[bucket + 1]);
+    }
+    else
+    {
+        // Find file (assumes that file names were sorted before this)
+        fileIndex = m_TableOfContents->Find(a_ResourcePathHash, 0, fileCount);
+    }
+
+    if (fileIndex == TableOfContents::NotFound)
+    {
+        return std::nullopt;
+    }
+
+    FileInfo fi = m_TableOfContents->GetFileInfo(fileIndex);
+    // The table of contents may only store part of the hash
+    fi.m_ResourcePathHash = a_ResourcePathHash;
+    return fi;
+}
+
+bool Archive::ReadFileOutsideArchive(ResourcePathHash const& a_Hash, std::vector<char>& a_OutData) const
+{
+#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+    std::unique_ptr<IFile> const file = OpenFileOutsideArchive(a_Hash);
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    // Read intermediate file content
+    size_t const fileSize = file->GetFileSize();
+    a_OutData.clear();
+    a_OutData.resize(fileSize);
+
+    if (file->Read(fileSize, 0, a_OutData))
+    {
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+std::unique_ptr<IFile> Archive::OpenFileOutsideArchive(ResourcePathHash const& a_Hash) const
+{
+#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+    if (!HasNewerFileOutsideArchive(a_Hash))
+    {
+        // File hasn't been updated since the archive was created, so we can just read it from the archive
+        return nullptr;
+    }
+
+    // Try to open the file. Returns a nullptr if the file can't be opened.
+    auto const intermediatePath = GetIntermediateFilePath(m_CurrentPlatform, a_Hash);
+    return s_FileFactory(intermediatePath.generic_string().c_str(), FileOpenMode::Read);
+#else
+    (void)a_Hash;
+    return nullptr;
+#endif
+}
+
+bool Archive::HasNewerFileOutsideArchive(ResourcePathHash const& a_Hash) const
+{
+#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+    if (m_IntermediateOverlay == nullptr || !m_IntermediateOverlay->HasNewerFile(a_Hash))
+    {
+        return false;
+    }
+
+    m_Statistics->RecordOverlayHit();
+    return true;
+#else
+    (void)a_Hash;
+    return false;
+#endif
+}
+
+bool Archive::LoadFileContent(FileInfo const& a_FileInfo, std::vector<char>& a_Data) const
+{
+    std::shared_ptr<ReadBuffer const> groupData = nullptr;
+    char const* const fileStart = a_FileInfo.m_Compression == Compression::None ? GetStoredData(a_FileInfo, groupData) : nullptr;
+    if (fileStart != nullptr)
+    {
+        ArchiveStatistics::Timer const timer{};
+
+        // Copy straight out of memory, which also avoids zero-filling the vector before overwriting it
+        if (m_VerifyChecksums.load(std::memory_order_relaxed) && !IsChecksumValid(a_FileInfo, fileStart))
+        {
+            return false;
+        }
+
+        a_Data.assign(fileStart, fileStart + a_FileInfo.m_Size);
+        m_Statistics->RecordRead(1, a_FileInfo.m_Size, timer);
+        return true;
+    }
+
+    a_Data.clear();
+    a_Data.resize(a_FileInfo.m_Size);
+
+    return LoadFileContent(a_FileInfo, a_Data.data());
+}
+
+bool Archive::LoadFileContent(FileInfo const& a_FileInfo, char* a_Buffer) const
+{
+    ArchiveStatistics::Timer const timer{};
+    bool const verifyChecksum = m_VerifyChecksums.load(std::memory_order_relaxed);
+    bool success = false;
+
+    std::shared_ptr<ReadBuffer const> groupData = nullptr;
+    if (char const* const storedData = GetStoredData(a_FileInfo, groupData))
+    {
+        success = (!verifyChecksum || IsChecksumValid(a_FileInfo, storedData))
+            && DecodeFileContent(a_FileInfo, storedData, a_Buffer);
+    }
+    else if (a_FileInfo.m_Compression == Compression::None)
+    {
+        success = ReadArchiveRange(a_FileInfo.m_Size, a_FileInfo.m_Offset, a_Buffer)
+            && (!verifyChecksum || IsChecksumValid(a_FileInfo, a_Buffer));
+    }
+    else
+    {
+        ReadBuffer storedData{};
+        success = ReadArchiveRange(a_FileInfo.m_StoredSize, a_FileInfo.m_Offset, storedData)
+            && (!verifyChecksum || IsChecksumValid(a_FileInfo, storedData.data()))
+            && DecodeFileContent(a_FileInfo, storedData.data(), a_Buffer);
+    }
+
+    if (success)
+    {
+        m_Statistics->RecordRead(1, a_FileInfo.m_Size, timer);
+    }
+
+    return success;
+}
+
+bool Archive::LoadFileRange(FileInfo const& a_FileInfo, size_t a_Offset, size_t a_NumBytes, char* a_Buffer, char const* a_ChunkTable) const
+{
+    ArchiveStatistics::Timer const timer{};
+    if (!ReadFileRange(a_FileInfo, a_Offset, a_NumBytes, a_Buffer, a_ChunkTable))
+    {
+        return false;
+    }
+
+    m_Statistics->RecordRead(1, a_NumBytes, timer);
+    return true;
+}
+
+bool Archive::ReadFileRange(FileInfo const& a_FileInfo, size_t a_Offset, size_t a_NumBytes, char* a_Buffer, char const* a_ChunkTable) const
+{
+    if (a_NumBytes == 0)
+    {
+        return true;
+    }
+
+    std::shared_ptr<ReadBuffer const> groupData = nullptr;
+    char const* const storedData = GetStoredData(a_FileInfo, groupData);
+
+    if (a_FileInfo.m_Compression == Compression::None)
+    {
+        if (storedData != nullptr)
+        {
+            memcpy(a_Buffer, storedData + a_Offset, a_NumBytes);
+            return true;
+        }
+
+        return ReadArchiveRange(a_NumBytes, a_FileInfo.m_Offset + a_Offset, a_Buffer);
+    }
+
+    size_t const chunkTableSize = GetCompressionChunkTableSize(a_FileInfo.m_Size);
+    ReadBuffer chunkTableData{};
+
+    if (storedData != nullptr)
+    {
+        a_ChunkTable = storedData;
+    }
+    else if (a_ChunkTable == nullptr)
+    {
+        if (!ReadChunkTable(a_FileInfo, chunkTableData))
+        {
+            return false;
+        }
+
+        a_ChunkTable = chunkTableData.data();
+    }
+
+    // Only read and decompress the chunks that overlap the requested range
+    size_t chunkDataOffset = 0;
+    size_t chunkDataSize = 0;
+    GetChunkDataRange(a_ChunkTable, a_FileInfo.m_Size, a_Offset, a_NumBytes, chunkDataOffset, chunkDataSize);
+
+    size_t const storedChunkDataSize = a_FileInfo.m_StoredSize - chunkTableSize;
+    if (chunkDataOffset > storedChunkDataSize || chunkDataSize > storedChunkDataSize - chunkDataOffset)
+    {
+        hako::Log("File with hash \"%s\" has an invalid chunk table. The archive might be corrupted.\n", a_FileInfo.m_ResourcePathHash.ToString().c_str());
+        return false;
+    }
+
+    size_t const chunkDataArchiveOffset = a_FileInfo.m_Offset + chunkTableSize + chunkDataOffset;
+    char const* chunkData = nullptr;
+    ReadBuffer chunkDataBuffer{};
+
+    if (storedData != nullptr)
+    {
+        chunkData = storedData + chunkTableSize + chunkDataOffset;
+    }
+    else
+    {
+        if (!ReadArchiveRange(chunkDataSize, chunkDataArchiveOffset, chunkDataBuffer))
+        {
+            return false;
+        }
+
+        chunkData = chunkDataBuffer.data();
+    }
+
+    if (!DecompressChunked(a_ChunkTable, a_FileInfo.m_Size, chunkData, chunkDataOffset, chunkDataSize, a_Offset, a_NumBytes, a_Buffer))
+    {
+        hako::Log("Unable to decompress file with hash \"%s\". The archive might be corrupted.\n", a_FileInfo.m_ResourcePathHash.ToString().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool Archive::VerifyFileContent(FileInfo const& a_FileInfo, ReadBuffer& a_ScratchBuffer, bool a_IsHashTruncated) const
+{
+    uint32_t checksum = 0;
+    if (!m_MappedArchive.empty())
+    {
+        checksum = ComputeCrc32c(m_MappedArchive.data() + a_FileInfo.m_Offset, a_FileInfo.m_StoredSize);
+    }
+    else
+    {
+        // Large files are checked in parts, so verification doesn't need to hold entire files in memory
+        for (size_t offset = 0; offset < a_FileInfo.m_StoredSize; offset += MaxCoalescedReadSize)
+        {
+            size_t const numBytes = std::min(MaxCoalescedReadSize, a_FileInfo.m_StoredSize - offset);
+            if (!ReadArchiveRange(numBytes, a_FileInfo.m_Offset + offset, a_ScratchBuffer))
+            {
+                hako::Log("Unable to read file with hash \"%s\" from the archive.\n", GetHashString(a_FileInfo.m_ResourcePathHash, a_IsHashTruncated).c_str());
+                return false;
+            }
+
+            checksum = ComputeCrc32c(a_ScratchBuffer.data(), numBytes, checksum);
+        }
+    }
+
+    if (checksum != a_FileInfo.m_Checksum)
+    {
+        hako::Log("File with hash \"%s\" does not match its checksum. The archive might be corrupted.\n", GetHashString(a_FileInfo.m_ResourcePathHash, a_IsHashTruncated).c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool Archive::ReadChunkTable(FileInfo const& a_FileInfo, ReadBuffer& a_OutChunkTable) const
+{
+    HAKO_ASSERT(a_FileInfo.m_Compression != Compression::None, "Only compressed files have a chunk table\n");
+
+    return ReadArchiveRange(GetCompressionChunkTableSize(a_FileInfo.m_Size), a_FileInfo.m_Offset, a_OutChunkTable);
+}
+
+bool Archive::ReadArchiveRange(size_t a_NumBytes, size_t a_Offset, ReadBuffer& a_Data) const
+{
+    a_Data.clear();
+    a_Data.resize(a_NumBytes);
+
+    return ReadArchiveRange(a_NumBytes, a_Offset, a_Data.data());
+}
+
+bool Archive::ReadArchiveRange(size_t a_NumBytes, size_t a_Offset, char* a_Buffer) const
+{
+    std::unique_lock<std::mutex> lock(m_ArchiveReaderMutex, std::defer_lock);
+    if (!m_ArchiveReader->SupportsConcurrentReads())
+    {
+        lock.lock();
+    }
+
+    return m_ArchiveReader->Read(a_NumBytes, a_Offset, a_Buffer);
+}
+
+void Archive::Prefetch(Span<ResourcePathHash const> a_ResourcePathHashes) const
+{
+    std::vector<std::pair<size_t, size_t>> unhintedRanges{};
+
+    {
+        std::unique_lock<std::mutex> lock(m_ArchiveReaderMutex, std::defer_lock);
+        if (!m_ArchiveReader->SupportsConcurrentReads())
+        {
+            lock.lock();
+        }
+
+        for (auto const& [offset, numBytes] : GetArchiveRanges(a_ResourcePathHashes))
+        {
+            if (!m_ArchiveReader->Prefetch(numBytes, offset))
+            {
+                unhintedRanges.emplace_back(offset, numBytes);
+            }
+        }
+    }
+
+    if (unhintedRanges.empty())
+    {
+        return;
+    }
+
+    // Without readahead hints, reading the ranges on an I/O thread is the next best way to get them cached
+    GetIOThreadPool().Enqueue([this, ranges = std::move(unhintedRanges)]()
+        {
+            ReadBuffer discardedData{};
+            for (auto const& [offset, numBytes] : ranges)
+            {
+                for (size_t readOffset = 0; readOffset < numBytes; readOffset += MaxCoalescedReadSize)
+                {
+                    ReadArchiveRange(std::min(MaxCoalescedReadSize, numBytes - readOffset), offset + readOffset, discardedData);
+                }
+            }
+        }
+    );
+}
+
+void Archive::Evict(Span<ResourcePathHash const> a_ResourcePathHashes) const
+{
+    std::unique_lock<std::mutex> lock(m_ArchiveReaderMutex, std::defer_lock);
+    if (!m_ArchiveReader->SupportsConcurrentReads())
+    {
+        lock.lock();
+    }
+
+    for (auto const& [offset, numBytes] : GetArchiveRanges(a_ResourcePathHashes))
+    {
+        m_ArchiveReader->Evict(numBytes, offset);
+    }
+}
+
+void Archive::SetVerifyChecksums(bool a_VerifyChecksums)
+{
+    m_VerifyChecksums = a_VerifyChecksums;
+}
+
+bool Archive::VerifyFile(ResourcePathHash const& a_ResourcePathHash) const
+{
+    std::optional<FileInfo> const fi = GetFileInfo(a_ResourcePathHash);
+    if (!fi)
+    {
+        hako::Log("Unable to find file with hash \"%s\" in archive.\n", a_ResourcePathHash.ToString().c_str());
+        return false;
+    }
+
+    // The file info carries the full hash it was looked up with
+    ReadBuffer scratchBuffer{};
+    return VerifyFileContent(*fi, scratchBuffer, false);
+}
+
+bool Archive::VerifyArchive(std::vector<ResourcePathHash>* a_OutCorruptedFiles) const
+{
+    // Hand out files in the order they are stored, so the archive is read front to back
+    std::vector<FileInfo> files{};
+    files.reserve(m_TableOfContents->GetFileCount());
+    for (size_t fileIndex = 0; fileIndex < m_TableOfContents->GetFileCount(); ++fileIndex)
+    {
+        files.push_back(m_TableOfContents->GetFileInfo(fileIndex));
+    }
+
+    std::sort(files.begin(), files.end(), [](FileInfo const& a_Lhs, FileInfo const& a_Rhs)
+        {
+            return a_Lhs.m_Offset < a_Rhs.m_Offset;
+        }
+    );
+
+    // The hashes come from the table of contents, which may only store their first 64 bits
+    bool const isHashTruncated = HasTruncatedHashes();
+
+    std::atomic<size_t> nextFile = 0;
+    std::vector<ResourcePathHash> corruptedFiles{};
+    std::mutex corruptedFilesMutex{};
+
+    auto const verifyFiles = [&]()
+        {
+            ReadBuffer scratchBuffer{};
+            for (size_t fileIndex = nextFile++; fileIndex < files.size(); fileIndex = nextFile++)
+            {
+                if (!VerifyFileContent(files[fileIndex], scratchBuffer, isHashTruncated))
+                {
+                    std::lock_guard<std::mutex> lock(corruptedFilesMutex);
+                    corruptedFiles.push_back(files[fileIndex].m_ResourcePathHash);
+                }
+            }
+        };
+
+    size_t const threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, files.size() > 0 ? files.size() : 1);
+    std::vector<std::thread> threads{};
+    threads.reserve(threadCount - 1);
+    for (size_t threadIndex = 1; threadIndex < threadCount; ++threadIndex)
+    {
+        threads.emplace_back(verifyFiles);
+    }
+
+    verifyFiles();
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    bool const success = corruptedFiles.empty();
+    if (a_OutCorruptedFiles != nullptr)
+    {
+        *a_OutCorruptedFiles = std::move(corruptedFiles);
+    }
+
+    return success;
+}
+
+bool Archive::StartAccessTrace(char const* a_TracePath)
+{
+    HAKO_ASSERT(a_TracePath && a_TracePath[0] != 0, "No access trace path provided\n");
+
+    std::unique_ptr<IFile> traceFile = s_FileFactory(a_TracePath, FileOpenMode::WriteTruncate);
+    if (traceFile == nullptr)
+    {
+        hako::Log("Unable to create access trace \"%s\".\n", a_TracePath);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_AccessTraceMutex);
+    m_AccessTrace = std::make_unique<AccessTraceWriter>(std::move(traceFile));
+    m_IsTracingAccesses = true;
+
+    return true;
+}
+
+void Archive::StopAccessTrace()
+{
+    std::lock_guard<std::mutex> lock(m_AccessTraceMutex);
+    m_IsTracingAccesses = false;
+    m_AccessTrace = nullptr;
+}
+
+void Archive::SetContentCacheBudget(size_t a_NumBytes)
+{
+    m_ContentCache->SetBudget(a_NumBytes);
+}
+
+std::shared_ptr<std::vector<char> const> Archive::ReadFileShared(ResourcePathHash const& a_ResourcePathHash) const
+{
+    return ReadFileShared(a_ResourcePathHash, nullptr);
+}
+
+std::shared_ptr<std::vector<char> const> Archive::ReadFileShared(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo) const
+{
+    RecordAccess(a_ResourcePathHash);
+
+#ifdef HAKO_READ_OUTSIDE_OF_ARCHIVE
+    // Files outside of the archive can change at any time, so they are never cached, and have to be checked before the cache so they aren't hidden by an older cached copy
+    {
+        auto buffer = std::make_shared<std::vector<char>>();
+        if (ReadFileOutsideArchive(a_ResourcePathHash, *buffer))
+        {
+            return buffer;
+        }
+    }
+#endif
+
+    if (!m_ContentCache->IsEnabled())
+    {
+        return LoadFileShared(a_ResourcePathHash, a_FileInfo);
+    }
+
+    if (ContentCache::Buffer buffer = m_ContentCache->Find(a_ResourcePathHash))
+    {
+        return buffer;
+    }
+
+    ContentCache::Buffer buffer = LoadFileShared(a_ResourcePathHash, a_FileInfo);
+    if (buffer != nullptr)
+    {
+        m_ContentCache->Insert(a_ResourcePathHash, buffer);
+    }
+
+    return buffer;
+}
+
+ContentCacheStats Archive::GetContentCacheStats() const
+{
+    return m_ContentCache->GetStats();
+}
+
+ArchiveStats Archive::GetStats() const
+{
+    return m_Statistics->GetStats();
+}
+
+void Archive::ResetStats()
+{
+    m_Statistics->Reset();
+}
+
+std::shared_ptr<std::vector<char> const> Archive::LoadFileShared(ResourcePathHash const& a_ResourcePathHash, FileInfo const* a_FileInfo) const
+{
+    auto buffer = std::make_shared<std::vector<char>>();
+
+    std::optional<FileInfo> const fi = GetFileInfo(a_ResourcePathHash, a_FileInfo);
+    HAKO_ASSERT(fi.has_value(), "Unable to find file with hash \"%s\" in archive.\n", a_ResourcePathHash.ToString().c_str());
+    if (!fi || !LoadFileContent(*fi, *buffer))
+    {
+        return nullptr;
+    }
+
+    return buffer;
+}
+
+std::vector<std::pair<size_t, size_t>> Archive::GetArchiveRanges(Span<ResourcePathHash const> a_ResourcePathHashes) const
+{
+    std::vector<std::pair<size_t, size_t>> fileRanges{};
+    fileRanges.reserve(a_ResourcePathHashes.size());
+
+    for (ResourcePathHash const& hash : a_ResourcePathHashes)
+    {
+        if (std::optional<FileInfo> const fi = GetFileInfo(hash))
+        {
+            fileRanges.emplace_back(fi->m_Offset, fi->m_StoredSize);
+        }
+    }
+
+    std::sort(fileRanges.begin(), fileRanges.end());
+
+    // Merge files that are (nearly) adjacent, so they are passed on as a single range
+    std::vector<std::pair<size_t, size_t>> ranges{};
+    for (auto const& [offset, numBytes] : fileRanges)
+    {
+        if (!ranges.empty() && offset <= ranges.back().first + ranges.back().second + MaxCoalescedReadGap)
+        {
+            size_t const rangeEnd = std::max(ranges.back().first + ranges.back().second, offset + numBytes);
+            ranges.back().second = rangeEnd - ranges.back().first;
+        }
+        else
+        {
+            ranges.emplace_back(offset, numBytes);
+        }
+    }
+
+    return ranges;
+}
+
+void Archive::RecordAccess(ResourcePathHash const& a_ResourcePathHash) const
+{
+    if (!m_IsTracingAccesses.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_AccessTraceMutex);
+    if (m_AccessTrace != nullptr)
+    {
+        m_AccessTrace->Record(a_ResourcePathHash);
+    }
+}
+
+ThreadPool& Archive::GetIOThreadPool() const
+{
+    std::lock_guard<std::mutex> lock(m_IOThreadPoolMutex);
+
+    if (m_IOThreadPool == nullptr)
+    {
+        size_t const threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, MaxIOThreadCount);
+        m_IOThreadPool = std::make_unique<ThreadPool>(threadCount);
+    }
+
+    return *m_IOThreadPool;
 }
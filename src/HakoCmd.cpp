@@ -2,7 +2,10 @@
 
 #include "Hako.h"
 
+#include <cinttypes>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <string>
 #include <vector>
 
@@ -71,6 +74,31 @@ namespace hako
 
 --overwrite_archive
     When used, overwrite the archive specified with --archive if it exists
+
+--compress
+    When used, compress archived files with Hako's built-in codec
+
+--lookup_index
+    When used, add a lookup index to the archive, which speeds up finding files in large archives
+
+--compact_toc
+    When used, store hashes in the table of contents with 64 bits and offsets with 32 bits where the archive allows it, which roughly halves its memory use
+
+--entry_alignment <bytes>
+    Align the start of every archived file to a multiple of this many bytes (a power of two, e.g. 4096)
+
+--threads <count>
+    Number of threads that copy files into the archive. Defaults to one thread per hardware thread.
+
+--access_trace <path_to_trace>
+    Lay out archived files in the order in which they were loaded in an access trace recorded with Archive::StartAccessTrace()
+
+--load_groups <path_to_manifest>
+    Lay out the files of every load group in a manifest contiguously, so Archive::LoadGroup() can read each group with a single read
+    Every "[group_name]" line starts a group, and every other non-empty line that doesn't start with '#' adds a resource path to the current group
+
+--verify
+    Check every file in the archive specified with --archive against its checksum instead of creating an archive
 )""");
 
         printf(R"""(
@@ -79,6 +107,8 @@ Example usage:
     Hako --platform Windows --serialize Assets --ext gltf --intermediate intermediate
     Hako --intermediate intermediate --archive arc.bin --overwrite_archive
     Hako --platform Windows --serialize Assets --intermediate intermediate --archive arc.bin --overwrite_archive
+    Hako --intermediate intermediate --archive arc.bin --overwrite_archive --load_groups LoadGroups.txt
+    Hako --archive arc.bin --verify
 )""");
     }
 
@@ -97,12 +127,108 @@ Example usage:
         char const* archivePath = nullptr;
         // If true, the archive at archivePath is overwritten if it exists
         bool overwriteExistingArchive = false;
+        // If true, archived files are compressed
+        bool compressArchive = false;
+        // If true, the archive gets a lookup index
+        bool writeLookupIndex = false;
+        // If true, the table of contents narrows hashes and offsets where possible
+        bool compactTableOfContents = false;
+        // Alignment of archived files. Null if not specified.
+        char const* entryAlignment = nullptr;
+        // Number of threads that copy files into the archive. Null if not specified.
+        char const* threadCount = nullptr;
+        // Access trace that determines the order of files in the archive. Null if not specified.
+        char const* accessTracePath = nullptr;
+        // Manifest of load groups to lay out contiguously. Null if not specified.
+        char const* loadGroupManifestPath = nullptr;
+        // If true, the archive at archivePath is verified instead of created
+        bool verifyArchive = false;
         // If true, serialize files regardless of when they were last serialized
         bool forceSerialization = false;
         // If true, a help message should be printed
         bool m_ShouldPrintHelp = false;
     };
 
+    bool VerifyArchive(char const* a_ArchivePath)
+    {
+        hako::Archive archive{};
+        archive.Open(a_ArchivePath);
+        if (!archive.IsOpen())
+        {
+            printf("Failed to open archive %s\n", a_ArchivePath);
+            return false;
+        }
+
+        std::vector<hako::ResourcePathHash> corruptedFiles{};
+        if (!archive.VerifyArchive(&corruptedFiles))
+        {
+            // Archives with 64-bit hashes don't know the rest of the hash, so only print what can be matched against a path's hash
+            bool const isHashTruncated = archive.HasTruncatedHashes();
+            if (isHashTruncated)
+            {
+                printf("The archive only stores the first 64 bits of every hash.\n");
+            }
+
+            for (hako::ResourcePathHash const& hash : corruptedFiles)
+            {
+                if (isHashTruncated)
+                {
+                    printf("Corrupted file: %016" PRIX64 "\n", hash.hash64[0]);
+                }
+                else
+                {
+                    printf("Corrupted file: %s\n", hash.ToString().c_str());
+                }
+            }
+
+            printf("Archive %s failed verification (%zu corrupted files)\n", a_ArchivePath, corruptedFiles.size());
+            return false;
+        }
+
+        printf("Successfully verified archive %s\n", a_ArchivePath);
+        return true;
+    }
+
+    bool ReadLoadGroupManifest(char const* a_ManifestPath, std::vector<hako::ArchiveLoadGroup>& a_OutLoadGroups)
+    {
+        std::ifstream manifest(a_ManifestPath);
+        if (!manifest)
+        {
+            printf("Unable to open load group manifest %s\n", a_ManifestPath);
+            return false;
+        }
+
+        std::string line{};
+        size_t lineNumber = 0;
+        while (std::getline(manifest, line))
+        {
+            ++lineNumber;
+
+            // Ignore trailing whitespace, including the carriage returns of files with Windows line endings
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            if (line.front() == '[' && line.back() == ']')
+            {
+                a_OutLoadGroups.emplace_back().m_Name = line.substr(1, line.size() - 2);
+            }
+            else if (a_OutLoadGroups.empty())
+            {
+                printf("Load group manifest %s lists a resource path before the first group (line %zu)\n", a_ManifestPath, lineNumber);
+                return false;
+            }
+            else
+            {
+                a_OutLoadGroups.back().m_ResourcePaths.push_back(line);
+            }
+        }
+
+        return true;
+    }
+
     CommandLineParams ParseCommandLineParams(int argc, char* argv[])
     {
         CommandLineParams params;
@@ -138,6 +264,38 @@ Example usage:
             {
                 params.overwriteExistingArchive = true;
             }
+            else if (strcmp(argv[i], "--compress") == 0)
+            {
+                params.compressArchive = true;
+            }
+            else if (strcmp(argv[i], "--lookup_index") == 0)
+            {
+                params.writeLookupIndex = true;
+            }
+            else if (strcmp(argv[i], "--compact_toc") == 0)
+            {
+                params.compactTableOfContents = true;
+            }
+            else if (params.entryAlignment == nullptr && strcmp(argv[i], "--entry_alignment") == 0)
+            {
+                params.entryAlignment = GetFlagValue(i, argc, argv);
+            }
+            else if (params.threadCount == nullptr && strcmp(argv[i], "--threads") == 0)
+            {
+                params.threadCount = GetFlagValue(i, argc, argv);
+            }
+            else if (params.accessTracePath == nullptr && strcmp(argv[i], "--access_trace") == 0)
+            {
+                params.accessTracePath = GetFlagValue(i, argc, argv);
+            }
+            else if (params.loadGroupManifestPath == nullptr && strcmp(argv[i], "--load_groups") == 0)
+            {
+                params.loadGroupManifestPath = GetFlagValue(i, argc, argv);
+            }
+            else if (strcmp(argv[i], "--verify") == 0)
+            {
+                params.verifyArchive = true;
+            }
             else if (strcmp(argv[i], "--force_serialization") == 0)
             {
                 params.forceSerialization = true;
@@ -154,6 +312,18 @@ Example usage:
 
     bool VerifyCommandLineParameters(CommandLineParams& a_Params)
     {
+        if (a_Params.verifyArchive)
+        {
+            // Verifying an existing archive doesn't depend on the platform or intermediate directory
+            if (a_Params.archivePath == nullptr)
+            {
+                printf("No archive path specified to verify.\nUse --help for more info.\n");
+                return false;
+            }
+
+            return true;
+        }
+
         bool success = true;
 
         if (a_Params.intermediateDirectory == nullptr)
@@ -214,6 +384,11 @@ Example usage:
             return EXIT_FAILURE;
         }
 
+        if (params.verifyArchive)
+        {
+            return VerifyArchive(params.archivePath) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
         bool success = true;
 
         if (params.intermediateDirectory)
@@ -237,7 +412,29 @@ Example usage:
         // Only create an archive if we have an archive path and nothing before this failed
         if (params.archivePath && success)
         {
-            success = hako::CreateArchive(params.platformEnum, params.archivePath, params.overwriteExistingArchive);
+            hako::ArchiveCreationSettings settings{};
+            settings.m_CompressFiles = params.compressArchive;
+            settings.m_WriteLookupIndex = params.writeLookupIndex;
+            settings.m_Allow64BitHashes = params.compactTableOfContents;
+            settings.m_Allow32BitOffsets = params.compactTableOfContents;
+            settings.m_AccessTracePath = params.accessTracePath;
+            if (params.entryAlignment != nullptr)
+            {
+                settings.m_EntryAlignment = strtoull(params.entryAlignment, nullptr, 10);
+            }
+
+            if (params.threadCount != nullptr)
+            {
+                settings.m_ThreadCount = strtoull(params.threadCount, nullptr, 10);
+            }
+
+            if (params.loadGroupManifestPath != nullptr && !ReadLoadGroupManifest(params.loadGroupManifestPath, settings.m_LoadGroups))
+            {
+                printf("Failed to create archive %s\n", params.archivePath);
+                return EXIT_FAILURE;
+            }
+
+            success = hako::CreateArchive(params.platformEnum, params.archivePath, params.overwriteExistingArchive, settings);
             if (success)
             {
                 printf("Successfully created archive %s\n", params.archivePath);
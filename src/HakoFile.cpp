@@ -1,8 +1,21 @@
 #include "HakoFile.h"
+#include "DirectFile.h"
+#include "MappedFile.h"
 
 #include <cassert>
+#include <cerrno>
 #include <filesystem>
 
+#if defined(HAKO_POSIX_FILE_IO)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
 using namespace hako;
 
 HakoFile::~HakoFile()
@@ -10,10 +23,218 @@ HakoFile::~HakoFile()
 	CloseFile();
 }
 
+#if defined(HAKO_POSIX_FILE_IO)
 bool HakoFile::Open(std::string const& a_FilePath, FileOpenMode a_FileOpenMode)
 {
 	int openFlags = 0;
-	if (a_FileOpenMode == FileOpenMode::Read)
+	if (a_FileOpenMode == FileOpenMode::Read || a_FileOpenMode == FileOpenMode::ReadMapped || a_FileOpenMode == FileOpenMode::ReadDirect)
+	{
+		openFlags = O_RDONLY;
+	}
+	else if (a_FileOpenMode == FileOpenMode::WriteTruncate)
+	{
+		openFlags = O_WRONLY | O_CREAT | O_TRUNC;
+	}
+	else if (a_FileOpenMode == FileOpenMode::WriteAppend)
+	{
+		openFlags = O_WRONLY | O_CREAT | O_APPEND;
+	}
+
+	openFlags |= O_CLOEXEC;
+
+	CloseFile();
+	m_FileDescriptor = open(a_FilePath.c_str(), openFlags, 0666);
+
+	return m_FileDescriptor >= 0;
+}
+
+bool HakoFile::Read(size_t a_NumBytes, size_t a_Offset, std::vector<char>& a_Buffer)
+{
+	assert(a_Buffer.size() >= a_NumBytes);
+
+	return Read(a_NumBytes, a_Offset, a_Buffer.data());
+}
+
+bool HakoFile::Read(size_t a_NumBytes, size_t a_Offset, char* a_Buffer)
+{
+	assert(m_FileDescriptor >= 0);
+
+	size_t bytesRead = 0;
+	while (bytesRead < a_NumBytes)
+	{
+		ssize_t const result = pread(m_FileDescriptor, a_Buffer + bytesRead, a_NumBytes - bytesRead, static_cast<off_t>(a_Offset + bytesRead));
+		if (result < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+		if (result <= 0)
+		{
+			// Either an error occurred, or we reached the end of the file before reading everything
+			return false;
+		}
+
+		bytesRead += static_cast<size_t>(result);
+	}
+
+	return true;
+}
+
+size_t HakoFile::GetFileSize()
+{
+	assert(m_FileDescriptor >= 0);
+
+	struct stat fileStat{};
+	if (fstat(m_FileDescriptor, &fileStat) != 0)
+	{
+		return 0;
+	}
+
+	return static_cast<size_t>(fileStat.st_size);
+}
+
+bool HakoFile::Write(size_t a_Offset, std::vector<char> const& a_Data)
+{
+	assert(m_FileDescriptor >= 0);
+
+	size_t bytesWritten = 0;
+	while (bytesWritten < a_Data.size())
+	{
+		ssize_t const result = pwrite(m_FileDescriptor, a_Data.data() + bytesWritten, a_Data.size() - bytesWritten, static_cast<off_t>(a_Offset + bytesWritten));
+		if (result < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+		if (result <= 0)
+		{
+			return false;
+		}
+
+		bytesWritten += static_cast<size_t>(result);
+	}
+
+	return true;
+}
+
+bool HakoFile::SupportsConcurrentReads() const
+{
+	// pread() doesn't touch the file position, so threads can't interfere with each other
+	return true;
+}
+
+bool HakoFile::SupportsConcurrentWrites() const
+{
+	// Same as pread(), pwrite() doesn't touch the file position
+	return true;
+}
+
+bool HakoFile::Prefetch(size_t a_NumBytes, size_t a_Offset)
+{
+#if defined(__linux__)
+	// Starts readahead into the page cache in the background
+	return posix_fadvise(m_FileDescriptor, static_cast<off_t>(a_Offset), static_cast<off_t>(a_NumBytes), POSIX_FADV_WILLNEED) == 0;
+#else
+	(void)a_NumBytes;
+	(void)a_Offset;
+	return false;
+#endif
+}
+
+void HakoFile::Evict(size_t a_NumBytes, size_t a_Offset)
+{
+#if defined(__linux__)
+	posix_fadvise(m_FileDescriptor, static_cast<off_t>(a_Offset), static_cast<off_t>(a_NumBytes), POSIX_FADV_DONTNEED);
+#else
+	(void)a_NumBytes;
+	(void)a_Offset;
+#endif
+}
+
+bool HakoFile::CopyFrom(IFile& a_Source, size_t a_NumBytes, size_t a_SourceOffset, size_t a_Offset)
+{
+#if defined(__linux__)
+	assert(m_FileDescriptor >= 0);
+
+	HakoFile* const source = dynamic_cast<HakoFile*>(&a_Source);
+	if (source == nullptr || source->m_FileDescriptor < 0)
+	{
+		return false;
+	}
+
+	// copy_file_range() copies inside the kernel, and shares the data instead of copying it on file systems with reflinks (e.g. XFS and btrfs)
+	size_t bytesCopied = 0;
+	while (bytesCopied < a_NumBytes)
+	{
+		loff_t sourceOffset = static_cast<loff_t>(a_SourceOffset + bytesCopied);
+		loff_t destinationOffset = static_cast<loff_t>(a_Offset + bytesCopied);
+		ssize_t const result = copy_file_range(source->m_FileDescriptor, &sourceOffset, m_FileDescriptor, &destinationOffset, a_NumBytes - bytesCopied, 0);
+		if (result < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+		if (result <= 0)
+		{
+			// Unsupported by the kernel or for these file systems, so fall back to sendfile() for the rest
+			break;
+		}
+
+		bytesCopied += static_cast<size_t>(result);
+	}
+
+	if (bytesCopied == a_NumBytes)
+	{
+		return true;
+	}
+
+	// sendfile() writes at the file position rather than at an offset
+	std::lock_guard<std::mutex> lock(m_FilePositionMutex);
+	if (lseek(m_FileDescriptor, static_cast<off_t>(a_Offset + bytesCopied), SEEK_SET) < 0)
+	{
+		return false;
+	}
+
+	while (bytesCopied < a_NumBytes)
+	{
+		off_t sourceOffset = static_cast<off_t>(a_SourceOffset + bytesCopied);
+		ssize_t const result = sendfile(m_FileDescriptor, source->m_FileDescriptor, &sourceOffset, a_NumBytes - bytesCopied);
+		if (result < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+		if (result <= 0)
+		{
+			return false;
+		}
+
+		bytesCopied += static_cast<size_t>(result);
+	}
+
+	return true;
+#else
+	(void)a_Source;
+	(void)a_NumBytes;
+	(void)a_SourceOffset;
+	(void)a_Offset;
+	return false;
+#endif
+}
+
+void HakoFile::CloseFile()
+{
+	if (m_FileDescriptor >= 0)
+	{
+		close(m_FileDescriptor);
+		m_FileDescriptor = -1;
+	}
+}
+#else
+bool HakoFile::Open(std::string const& a_FilePath, FileOpenMode a_FileOpenMode)
+{
+	std::ios::openmode openFlags{};
+	if (a_FileOpenMode == FileOpenMode::Read || a_FileOpenMode == FileOpenMode::ReadMapped || a_FileOpenMode == FileOpenMode::ReadDirect)
 	{
 		openFlags = std::ios::in;
 	}
@@ -34,11 +255,16 @@ bool HakoFile::Open(std::string const& a_FilePath, FileOpenMode a_FileOpenMode)
 }
 
 bool HakoFile::Read(size_t a_NumBytes, size_t a_Offset, std::vector<char>& a_Buffer)
+{
+	return Read(a_NumBytes, a_Offset, a_Buffer.data());
+}
+
+bool HakoFile::Read(size_t a_NumBytes, size_t a_Offset, char* a_Buffer)
 {
 	assert(m_FileHandle != nullptr);
 
 	m_FileHandle->seekg(a_Offset, std::ios_base::beg);
-	m_FileHandle->read(a_Buffer.data(), a_NumBytes);
+	m_FileHandle->read(a_Buffer, a_NumBytes);
 
 	return !m_FileHandle->fail();
 }
@@ -61,6 +287,33 @@ bool HakoFile::Write(size_t a_Offset, std::vector<char> const& a_Data)
 	return !m_FileHandle->fail();
 }
 
+bool HakoFile::SupportsConcurrentReads() const
+{
+	// Reads seek the shared stream before reading
+	return false;
+}
+
+bool HakoFile::SupportsConcurrentWrites() const
+{
+	// Writes seek the shared stream before writing
+	return false;
+}
+
+bool HakoFile::Prefetch(size_t, size_t)
+{
+	// Streams don't expose a way to pass on readahead hints
+	return false;
+}
+
+void HakoFile::Evict(size_t, size_t)
+{ }
+
+bool HakoFile::CopyFrom(IFile&, size_t, size_t, size_t)
+{
+	// Streams can only be copied through a buffer
+	return false;
+}
+
 void HakoFile::CloseFile()
 {
 	if (m_FileHandle != nullptr)
@@ -73,9 +326,34 @@ void HakoFile::CloseFile()
 		m_FileHandle = nullptr;
 	}
 }
+#endif
 
 std::unique_ptr<IFile> hako::HakoFileFactory(std::string const& a_FilePath, FileOpenMode a_FileOpenMode)
 {
+	if (a_FileOpenMode == FileOpenMode::ReadMapped)
+	{
+		std::unique_ptr<MappedFile> mappedFile = std::make_unique<MappedFile>();
+		if (mappedFile->Open(a_FilePath))
+		{
+			return mappedFile;
+		}
+
+		// Fall back to regular reads if the file can't be mapped
+	}
+
+#if defined(HAKO_DIRECT_FILE_IO)
+	if (a_FileOpenMode == FileOpenMode::ReadDirect)
+	{
+		std::unique_ptr<DirectFile> directFile = std::make_unique<DirectFile>();
+		if (directFile->Open(a_FilePath))
+		{
+			return directFile;
+		}
+
+		// Fall back to regular reads if the file system doesn't support direct I/O
+	}
+#endif
+
 	std::unique_ptr<HakoFile> file = std::make_unique<HakoFile>();
 	if (file->Open(a_FilePath, a_FileOpenMode))
 	{
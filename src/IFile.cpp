@@ -1 +1,17 @@
 #include "IFile.h"
+
+#include <cstring>
+
+using namespace hako;
+
+bool IFile::Read(size_t a_NumBytes, size_t a_Offset, char* a_Buffer)
+{
+    std::vector<char> buffer(a_NumBytes);
+    if (!Read(a_NumBytes, a_Offset, buffer))
+    {
+        return false;
+    }
+
+    memcpy(a_Buffer, buffer.data(), a_NumBytes);
+    return true;
+}
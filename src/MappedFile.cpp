@@ -0,0 +1,212 @@
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace hako;
+
+MappedFile::~MappedFile()
+{
+	CloseFile();
+}
+
+bool MappedFile::Open(std::string const& a_FilePath)
+{
+	CloseFile();
+
+#if defined(_WIN32)
+	HANDLE const file = CreateFileA(a_FilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	m_FileHandle = file;
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseFile();
+		return false;
+	}
+
+	HANDLE const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseFile();
+		return false;
+	}
+	m_MappingHandle = mapping;
+
+	m_Data = static_cast<char const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int const fileDescriptor = open(a_FilePath.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStat{};
+	if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	// The mapping keeps its own reference to the file, so the descriptor is not needed after this
+	void* const data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, fileDescriptor, 0);
+	close(fileDescriptor);
+
+	if (data != MAP_FAILED)
+	{
+		m_Data = static_cast<char const*>(data);
+		m_Size = static_cast<size_t>(fileStat.st_size);
+	}
+#endif
+
+	if (m_Data == nullptr)
+	{
+		CloseFile();
+		return false;
+	}
+
+	return true;
+}
+
+bool MappedFile::Read(size_t a_NumBytes, size_t a_Offset, std::vector<char>& a_Buffer)
+{
+	assert(a_Buffer.size() >= a_NumBytes);
+
+	return Read(a_NumBytes, a_Offset, a_Buffer.data());
+}
+
+bool MappedFile::Read(size_t a_NumBytes, size_t a_Offset, char* a_Buffer)
+{
+	assert(m_Data != nullptr);
+
+	if (a_Offset > m_Size || a_NumBytes > m_Size - a_Offset)
+	{
+		return false;
+	}
+
+	memcpy(a_Buffer, m_Data + a_Offset, a_NumBytes);
+	return true;
+}
+
+bool MappedFile::Write(size_t, std::vector<char> const&)
+{
+	// Mapped files are read-only
+	return false;
+}
+
+size_t MappedFile::GetFileSize()
+{
+	return m_Size;
+}
+
+bool MappedFile::SupportsConcurrentReads() const
+{
+	return true;
+}
+
+bool MappedFile::Prefetch(size_t a_NumBytes, size_t a_Offset)
+{
+#if defined(_WIN32)
+	(void)a_NumBytes;
+	(void)a_Offset;
+	return false;
+#else
+	void* pageStart = nullptr;
+	size_t pageRangeSize = 0;
+	if (!GetPageRange(a_NumBytes, a_Offset, pageStart, pageRangeSize))
+	{
+		return false;
+	}
+
+	// Starts paging the range in without waiting for it
+	return madvise(pageStart, pageRangeSize, MADV_WILLNEED) == 0;
+#endif
+}
+
+void MappedFile::Evict(size_t a_NumBytes, size_t a_Offset)
+{
+#if defined(_WIN32)
+	(void)a_NumBytes;
+	(void)a_Offset;
+#else
+	void* pageStart = nullptr;
+	size_t pageRangeSize = 0;
+	if (GetPageRange(a_NumBytes, a_Offset, pageStart, pageRangeSize))
+	{
+		// The mapping is read-only, so dropped pages are simply read from the file again on the next access
+		madvise(pageStart, pageRangeSize, MADV_DONTNEED);
+	}
+#endif
+}
+
+Span<char const> MappedFile::GetMappedContent() const
+{
+	return { m_Data, m_Size };
+}
+
+#if !defined(_WIN32)
+bool MappedFile::GetPageRange(size_t a_NumBytes, size_t a_Offset, void*& a_OutPageStart, size_t& a_OutPageRangeSize) const
+{
+	if (m_Data == nullptr || a_Offset >= m_Size)
+	{
+		return false;
+	}
+
+	a_NumBytes = std::min(a_NumBytes, m_Size - a_Offset);
+
+	// madvise() expects a page-aligned address. The mapping itself starts at a page boundary.
+	size_t const pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t const alignedOffset = a_Offset - a_Offset % pageSize;
+
+	a_OutPageStart = const_cast<char*>(m_Data) + alignedOffset;
+	a_OutPageRangeSize = a_Offset + a_NumBytes - alignedOffset;
+	return true;
+}
+#endif
+
+void MappedFile::CloseFile()
+{
+#if defined(_WIN32)
+	if (m_Data != nullptr)
+	{
+		UnmapViewOfFile(m_Data);
+	}
+
+	if (m_MappingHandle != nullptr)
+	{
+		CloseHandle(m_MappingHandle);
+		m_MappingHandle = nullptr;
+	}
+
+	if (m_FileHandle != nullptr)
+	{
+		CloseHandle(m_FileHandle);
+		m_FileHandle = nullptr;
+	}
+#else
+	if (m_Data != nullptr)
+	{
+		munmap(const_cast<char*>(m_Data), m_Size);
+	}
+#endif
+
+	m_Data = nullptr;
+	m_Size = 0;
+}
@@ -0,0 +1,55 @@
+#include "MemoryFile.h"
+
+#include <cassert>
+#include <cstring>
+
+using namespace hako;
+
+MemoryFile::MemoryFile(Span<char const> a_Data)
+	: m_Data(a_Data)
+{ }
+
+bool MemoryFile::Read(size_t a_NumBytes, size_t a_Offset, std::vector<char>& a_Buffer)
+{
+	assert(a_Buffer.size() >= a_NumBytes);
+
+	return Read(a_NumBytes, a_Offset, a_Buffer.data());
+}
+
+bool MemoryFile::Read(size_t a_NumBytes, size_t a_Offset, char* a_Buffer)
+{
+	if (a_Offset > m_Data.size() || a_NumBytes > m_Data.size() - a_Offset)
+	{
+		return false;
+	}
+
+	memcpy(a_Buffer, m_Data.data() + a_Offset, a_NumBytes);
+	return true;
+}
+
+bool MemoryFile::Write(size_t, std::vector<char> const&)
+{
+	// The memory belongs to the caller and may be read-only
+	return false;
+}
+
+size_t MemoryFile::GetFileSize()
+{
+	return m_Data.size();
+}
+
+bool MemoryFile::SupportsConcurrentReads() const
+{
+	return true;
+}
+
+bool MemoryFile::Prefetch(size_t, size_t)
+{
+	// The content is already in memory
+	return true;
+}
+
+Span<char const> MemoryFile::GetMappedContent() const
+{
+	return m_Data;
+}
@@ -0,0 +1,144 @@
+#include "RelocatableBlob.h"
+
+#include "HakoLog.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace hako;
+
+static_assert(sizeof(void*) <= sizeof(uint64_t), "Pointers in relocatable blobs are stored in 64-bit slots");
+
+size_t RelocatableBlobWriter::Allocate(size_t a_NumBytes, size_t a_Alignment)
+{
+    assert(a_Alignment > 0 && (a_Alignment & (a_Alignment - 1)) == 0 && a_Alignment <= RelocatableBlobAlignment);
+
+    size_t const offset = (m_Payload.size() + a_Alignment - 1) & ~(a_Alignment - 1);
+    m_Payload.resize(offset + a_NumBytes);
+
+    return offset;
+}
+
+size_t RelocatableBlobWriter::Write(void const* a_Data, size_t a_NumBytes, size_t a_Alignment)
+{
+    size_t const offset = Allocate(a_NumBytes, a_Alignment);
+    if (a_NumBytes > 0)
+    {
+        memcpy(m_Payload.data() + offset, a_Data, a_NumBytes);
+    }
+
+    return offset;
+}
+
+void RelocatableBlobWriter::SetPointer(size_t a_PointerOffset, size_t a_TargetOffset)
+{
+    assert(a_PointerOffset % sizeof(uint64_t) == 0 && a_PointerOffset + sizeof(uint64_t) <= m_Payload.size());
+    assert(a_TargetOffset <= m_Payload.size());
+
+    uint64_t const targetOffset = a_TargetOffset;
+    memcpy(m_Payload.data() + a_PointerOffset, &targetOffset, sizeof(targetOffset));
+    m_Fixups.push_back(a_PointerOffset);
+}
+
+size_t RelocatableBlobWriter::GetPayloadSize() const
+{
+    return m_Payload.size();
+}
+
+size_t RelocatableBlobWriter::Finish(std::vector<char>& a_OutBuffer) const
+{
+    // Sorted fixups patch the payload front to back, and let FixupRelocatableBlob() reject slots that would be patched twice
+    std::vector<uint64_t> fixups = m_Fixups;
+    std::sort(fixups.begin(), fixups.end());
+    fixups.erase(std::unique(fixups.begin(), fixups.end()), fixups.end());
+
+    RelocatableBlobHeader header{};
+    header.m_FixupCount = static_cast<uint32_t>(fixups.size());
+    header.m_PayloadSize = m_Payload.size();
+
+    size_t const fixupTableSize = fixups.size() * sizeof(uint64_t);
+    header.m_PayloadOffset = (sizeof(header) + fixupTableSize + RelocatableBlobAlignment - 1) & ~(RelocatableBlobAlignment - 1);
+
+    a_OutBuffer.clear();
+    a_OutBuffer.resize(header.m_PayloadOffset + m_Payload.size());
+
+    memcpy(a_OutBuffer.data(), &header, sizeof(header));
+    if (fixupTableSize > 0)
+    {
+        memcpy(a_OutBuffer.data() + sizeof(header), fixups.data(), fixupTableSize);
+    }
+
+    if (!m_Payload.empty())
+    {
+        memcpy(a_OutBuffer.data() + header.m_PayloadOffset, m_Payload.data(), m_Payload.size());
+    }
+
+    return a_OutBuffer.size();
+}
+
+namespace hako
+{
+    void* FixupRelocatableBlob(char* a_Blob, size_t a_BlobSize)
+    {
+        if (reinterpret_cast<uintptr_t>(a_Blob) % RelocatableBlobAlignment != 0)
+        {
+            hako::Log("Relocatable blob is not aligned to %zu bytes.\n", RelocatableBlobAlignment);
+            return nullptr;
+        }
+
+        RelocatableBlobHeader header{};
+        RelocatableBlobHeader const expectedHeader{};
+        if (a_BlobSize < sizeof(header))
+        {
+            hako::Log("Buffer is too small to contain a relocatable blob.\n");
+            return nullptr;
+        }
+
+        memcpy(&header, a_Blob, sizeof(header));
+        if (memcmp(header.m_Magic, expectedHeader.m_Magic, sizeof(header.m_Magic)) != 0 || header.m_Version != expectedHeader.m_Version)
+        {
+            hako::Log("Buffer does not contain a relocatable blob, or the blob was written by an incompatible version of Hako.\n");
+            return nullptr;
+        }
+
+        size_t const fixupTableEnd = sizeof(header) + static_cast<size_t>(header.m_FixupCount) * sizeof(uint64_t);
+        if (header.m_PayloadOffset % RelocatableBlobAlignment != 0 || header.m_PayloadOffset < fixupTableEnd
+            || header.m_PayloadOffset > a_BlobSize || header.m_PayloadSize > a_BlobSize - header.m_PayloadOffset)
+        {
+            hako::Log("Relocatable blob has an invalid layout. The blob might be corrupted.\n");
+            return nullptr;
+        }
+
+        char* const payload = a_Blob + header.m_PayloadOffset;
+        uint64_t const* const fixups = reinterpret_cast<uint64_t const*>(a_Blob + sizeof(header));
+
+        // Validate every fixup before patching any, so an invalid blob is left untouched
+        for (uint32_t fixupIndex = 0; fixupIndex < header.m_FixupCount; ++fixupIndex)
+        {
+            uint64_t const pointerOffset = fixups[fixupIndex];
+            if (header.m_PayloadSize < sizeof(uint64_t) || pointerOffset > header.m_PayloadSize - sizeof(uint64_t) || pointerOffset % sizeof(uint64_t) != 0
+                || (fixupIndex > 0 && pointerOffset <= fixups[fixupIndex - 1]))
+            {
+                hako::Log("Relocatable blob has an invalid fixup table. The blob might be corrupted.\n");
+                return nullptr;
+            }
+
+            uint64_t targetOffset = 0;
+            memcpy(&targetOffset, payload + pointerOffset, sizeof(targetOffset));
+            if (targetOffset > header.m_PayloadSize)
+            {
+                hako::Log("Relocatable blob has a pointer outside of its payload. The blob might be corrupted.\n");
+                return nullptr;
+            }
+        }
+
+        for (uint32_t fixupIndex = 0; fixupIndex < header.m_FixupCount; ++fixupIndex)
+        {
+            uint64_t* const slot = reinterpret_cast<uint64_t*>(payload + fixups[fixupIndex]);
+            *slot = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(payload + *slot));
+        }
+
+        return payload;
+    }
+}
@@ -0,0 +1,291 @@
+#include "StreamingScheduler.h"
+
+#include "HakoLog.h"
+
+#include <algorithm>
+
+using namespace hako;
+
+bool StreamingScheduler::QueuedRequest::operator<(QueuedRequest const& a_Rhs) const
+{
+    if (m_Priority != a_Rhs.m_Priority)
+    {
+        return m_Priority > a_Rhs.m_Priority;
+    }
+
+    if (m_Deadline != a_Rhs.m_Deadline)
+    {
+        return m_Deadline < a_Rhs.m_Deadline;
+    }
+
+    if (m_ArchiveOffset != a_Rhs.m_ArchiveOffset)
+    {
+        return m_ArchiveOffset < a_Rhs.m_ArchiveOffset;
+    }
+
+    return m_RequestId < a_Rhs.m_RequestId;
+}
+
+StreamingScheduler::StreamingScheduler(Archive const& a_Archive, StreamingSchedulerSettings const& a_Settings)
+    : m_Archive(a_Archive)
+    , m_Settings(a_Settings)
+{
+    size_t const threadCount = std::max<size_t>(m_Settings.m_ThreadCount, 1);
+
+    m_Threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        m_Threads.emplace_back(&StreamingScheduler::WorkerLoop, this);
+    }
+}
+
+StreamingScheduler::~StreamingScheduler()
+{
+    CancelAll();
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ShuttingDown = true;
+    }
+
+    m_StateChanged.notify_all();
+
+    for (std::thread& thread : m_Threads)
+    {
+        thread.join();
+    }
+}
+
+StreamingRequestId StreamingScheduler::Request(ResourcePathHash const& a_ResourcePathHash, int32_t a_Priority, Clock::time_point a_Deadline, Callback a_Callback)
+{
+    std::optional<Archive::FileInfo> const fi = m_Archive.GetFileInfo(a_ResourcePathHash);
+    if (!fi)
+    {
+        hako::Log("Unable to find file with hash \"%s\" in archive.\n", a_ResourcePathHash.ToString().c_str());
+        return 0;
+    }
+
+    QueuedRequest request{};
+    request.m_Priority = a_Priority;
+    request.m_Deadline = a_Deadline;
+    request.m_ArchiveOffset = fi->m_Offset;
+    request.m_ResourcePathHash = a_ResourcePathHash;
+    request.m_Size = fi->m_Size;
+    request.m_Callback = std::move(a_Callback);
+
+    StreamingRequestId requestId = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        requestId = m_NextRequestId++;
+        request.m_RequestId = requestId;
+        m_QueuedRequests[requestId] = m_Queue.insert(std::move(request)).first;
+    }
+
+    m_StateChanged.notify_one();
+    return requestId;
+}
+
+StreamingRequestId StreamingScheduler::Request(ResourcePathHash const& a_ResourcePathHash, int32_t a_Priority, Callback a_Callback)
+{
+    return Request(a_ResourcePathHash, a_Priority, Clock::time_point::max(), std::move(a_Callback));
+}
+
+bool StreamingScheduler::Reprioritize(StreamingRequestId a_RequestId, int32_t a_Priority)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto const it = m_QueuedRequests.find(a_RequestId);
+    if (it == m_QueuedRequests.end())
+    {
+        return false;
+    }
+
+    // Re-insert the request, as its position in the queue depends on its priority
+    Queue::node_type node = m_Queue.extract(it->second);
+    node.value().m_Priority = a_Priority;
+    it->second = m_Queue.insert(std::move(node)).position;
+
+    return true;
+}
+
+bool StreamingScheduler::SetDeadline(StreamingRequestId a_RequestId, Clock::time_point a_Deadline)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto const it = m_QueuedRequests.find(a_RequestId);
+    if (it == m_QueuedRequests.end())
+    {
+        return false;
+    }
+
+    Queue::node_type node = m_Queue.extract(it->second);
+    node.value().m_Deadline = a_Deadline;
+    it->second = m_Queue.insert(std::move(node)).position;
+
+    return true;
+}
+
+bool StreamingScheduler::Cancel(StreamingRequestId a_RequestId)
+{
+    std::vector<QueuedRequest> cancelledRequests{};
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto const it = m_QueuedRequests.find(a_RequestId);
+        if (it == m_QueuedRequests.end())
+        {
+            return false;
+        }
+
+        cancelledRequests.push_back(std::move(m_Queue.extract(it->second).value()));
+        m_QueuedRequests.erase(it);
+    }
+
+    // Waiters may be waiting for the queue to drain
+    m_StateChanged.notify_all();
+
+    NotifyCancelled(cancelledRequests);
+    return true;
+}
+
+void StreamingScheduler::CancelAll()
+{
+    std::vector<QueuedRequest> cancelledRequests{};
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        cancelledRequests.reserve(m_Queue.size());
+        while (!m_Queue.empty())
+        {
+            cancelledRequests.push_back(std::move(m_Queue.extract(m_Queue.begin()).value()));
+        }
+
+        m_QueuedRequests.clear();
+    }
+
+    m_StateChanged.notify_all();
+
+    NotifyCancelled(cancelledRequests);
+}
+
+void StreamingScheduler::WaitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_StateChanged.wait(lock, [this]() { return m_Queue.empty() && m_InFlightRequestCount == 0; });
+}
+
+size_t StreamingScheduler::GetQueuedRequestCount() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Queue.size();
+}
+
+size_t StreamingScheduler::GetInFlightBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_InFlightBytes;
+}
+
+void StreamingScheduler::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while (true)
+    {
+        m_StateChanged.wait(lock, [this]() { return !m_Queue.empty() || m_ShuttingDown; });
+
+        if (m_Queue.empty())
+        {
+            // Shutting down, and all remaining requests have been cancelled
+            return;
+        }
+
+        Queue::iterator const next = GetNextRequest();
+
+        // Oversized requests may go out on their own, so they can't block the queue forever
+        if (m_Settings.m_MaxInFlightBytes > 0 && m_InFlightBytes > 0 && m_InFlightBytes + next->m_Size > m_Settings.m_MaxInFlightBytes)
+        {
+            m_StateChanged.wait(lock);
+            continue;
+        }
+
+        Clock::time_point const now = Clock::now();
+        if (m_Settings.m_MaxBytesPerSecond > 0 && now < m_NextDispatchTime)
+        {
+            // The request to dispatch may change while waiting, so pick again afterwards
+            m_StateChanged.wait_until(lock, m_NextDispatchTime);
+            continue;
+        }
+
+        QueuedRequest request = std::move(m_Queue.extract(next).value());
+        m_QueuedRequests.erase(request.m_RequestId);
+
+        m_LastDispatchedOffset = request.m_ArchiveOffset;
+        m_InFlightBytes += request.m_Size;
+        ++m_InFlightRequestCount;
+
+        if (m_Settings.m_MaxBytesPerSecond > 0)
+        {
+            auto const transferTime = std::chrono::duration<double>(static_cast<double>(request.m_Size) / static_cast<double>(m_Settings.m_MaxBytesPerSecond));
+            m_NextDispatchTime = std::max(now, m_NextDispatchTime) + std::chrono::duration_cast<Clock::duration>(transferTime);
+        }
+
+        lock.unlock();
+
+        std::vector<char> data{};
+        StreamingRequestResult result{};
+        result.m_RequestId = request.m_RequestId;
+        result.m_ResourcePathHash = request.m_ResourcePathHash;
+        result.m_Status = m_Archive.ReadFile(request.m_ResourcePathHash, data) ? StreamingStatus::Completed : StreamingStatus::Failed;
+        result.m_MissedDeadline = Clock::now() > request.m_Deadline;
+
+        if (request.m_Callback)
+        {
+            request.m_Callback(result, data);
+        }
+
+        // The data counts as in flight until the callback has handled it
+        lock.lock();
+        m_InFlightBytes -= request.m_Size;
+        --m_InFlightRequestCount;
+
+        m_StateChanged.notify_all();
+    }
+}
+
+StreamingScheduler::Queue::iterator StreamingScheduler::GetNextRequest() const
+{
+    // Requests with the same priority and deadline as the most urgent request are swept through in archive order,
+    // continuing from the last dispatched offset and wrapping around to the start of the archive
+    Queue::iterator const first = m_Queue.begin();
+
+    QueuedRequest sweepPosition{};
+    sweepPosition.m_Priority = first->m_Priority;
+    sweepPosition.m_Deadline = first->m_Deadline;
+    sweepPosition.m_ArchiveOffset = m_LastDispatchedOffset;
+
+    Queue::iterator const next = m_Queue.lower_bound(sweepPosition);
+    if (next == m_Queue.end() || next->m_Priority != first->m_Priority || next->m_Deadline != first->m_Deadline)
+    {
+        return first;
+    }
+
+    return next;
+}
+
+void StreamingScheduler::NotifyCancelled(std::vector<QueuedRequest>& a_CancelledRequests)
+{
+    std::vector<char> data{};
+    for (QueuedRequest& request : a_CancelledRequests)
+    {
+        if (request.m_Callback)
+        {
+            StreamingRequestResult result{};
+            result.m_RequestId = request.m_RequestId;
+            result.m_ResourcePathHash = request.m_ResourcePathHash;
+            result.m_Status = StreamingStatus::Cancelled;
+            request.m_Callback(result, data);
+        }
+    }
+}